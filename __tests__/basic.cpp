@@ -1,6 +1,7 @@
 #include <eosio/eosio.hpp>
 
 #include <sx.hamburger/hamburger.hpp>
+#include <sx.hamburger/twap.hpp>
 
 using namespace eosio;
 
@@ -17,6 +18,227 @@ public:
         print( reserveOut );
     }
 
+    [[eosio::action]]
+    void readreserves( const uint64_t pair_id )
+    {
+        const auto [ reserve0, reserve1 ] = hamburger::read_reserves( pair_id );
+        print( reserve0 );
+        print( reserve1 );
+    }
+
+    [[eosio::action]]
+    void getmany( const std::vector<std::pair<uint64_t, symbol>> pairs )
+    {
+        for ( const auto& [ reserveIn, reserveOut ] : hamburger::get_reserves_many( pairs ) ) {
+            print( reserveIn );
+            print( reserveOut );
+        }
+    }
+
+    [[eosio::action]]
+    void getsnapshot( const uint64_t pair_id, const symbol sort )
+    {
+        hamburger::snapshot snapshot;
+        for ( int i = 0; i < 2; ++i ) {
+            const auto [ reserveIn, reserveOut ] = snapshot.get_reserves( pair_id, sort );
+            print( reserveIn );
+            print( reserveOut );
+            print( snapshot.get_fee() );
+        }
+    }
+
+    [[eosio::action]]
+    void getamountout( const uint64_t pair_id, const asset in )
+    {
+        print( hamburger::get_amount_out( pair_id, in ) );
+    }
+
+    [[eosio::action]]
+    void getquotes( const uint64_t pair_id, const asset in )
+    {
+        // one pair lookup per quote, config read once
+        print( hamburger::get_amount_out( pair_id, in ) );
+        print( hamburger::get_amount_in( pair_id, hamburger::get_amount_out( pair_id, in ) ) );
+#ifdef HAMBURGER_PROFILE
+        hamburger::profile::print();
+#endif
+    }
+
+    [[eosio::action]]
+    void getamountin( const uint64_t pair_id, const asset out )
+    {
+        print( hamburger::get_amount_in( pair_id, out ) );
+    }
+
+    [[eosio::action]]
+    void getimpact( const uint64_t pair_id, const asset in, const uint64_t slippage )
+    {
+        const auto quote = hamburger::quote_with_impact( pair_id, in, slippage );
+        print( quote.out );
+        print( quote.min_out );
+        print( quote.impact );
+    }
+
+    [[eosio::action]]
+    void getprice( const uint64_t pair_id, const symbol sort, const asset price )
+    {
+        print( hamburger::get_amount_to_price( pair_id, sort, price ) );
+    }
+
+    [[eosio::action]]
+    void snapshots( const std::vector<uint64_t> pair_ids )
+    {
+        const std::vector<char> payload = hamburger::pack( hamburger::get_reserve_snapshots( pair_ids ) );
+        print( payload.size() );
+        for ( const auto& snapshot : hamburger::unpack( payload ) ) {
+            print( snapshot.reserve0 );
+            print( hamburger::get_amount_out( snapshot, false, 10000 ) );
+        }
+    }
+
+    [[eosio::action]]
+    void indexpairs( const uint64_t lower_bound )
+    {
+        print( hamburger::index_pairs( get_self(), get_self(), lower_bound ) );
+    }
+
+    [[eosio::action]]
+    void getpairid( const extended_symbol token0, const extended_symbol token1 )
+    {
+        static_assert( hamburger::pair_key( {{"EOS", 4}, "eosio.token"_n}, {{"USDT", 4}, "tethertether"_n} ) == hamburger::pair_key( {{"USDT", 4}, "tethertether"_n}, {{"EOS", 4}, "eosio.token"_n} ) );
+        print( hamburger::get_pair_id( get_self(), token0, token1 ) );
+        print( " " );
+        print( hamburger::get_pair_id( get_self(), token1, token0 ) );
+        print( " " );
+        hamburger::snapshot snapshot;
+        print( snapshot.get_pair_id( get_self(), token0, token1 ) );
+    }
+
+    [[eosio::action]]
+    void quotepath( const asset in, const std::vector<uint64_t> pair_ids )
+    {
+        for ( const asset out : hamburger::quote_path( in, pair_ids ) ) {
+            print( out );
+        }
+    }
+
+    [[eosio::action]]
+    void getarb( const uint64_t pair_a, const uint64_t pair_b, const symbol base )
+    {
+        const uint8_t fee = hamburger::get_fee();
+        const auto [ in, profit ] = hamburger::get_arbitrage( hamburger::get_reserves( pair_a, base ), fee, hamburger::get_reserves( pair_b, base ), fee );
+        print( in );
+        print( profit );
+    }
+
+    [[eosio::action]]
+    void getrewards( const uint64_t pair_id, const asset in, const asset out )
+    {
+        print( hamburger::get_rewards( pair_id, in, out ) );
+#ifdef HAMBURGER_PROFILE
+        hamburger::profile::print();
+#endif
+    }
+
+    [[eosio::action]]
+    void getdeposit( const name owner )
+    {
+        const auto deposit = hamburger::get_deposit( owner );
+        if ( !deposit ) return;
+        print( deposit->quantity0 );
+        print( deposit->quantity1 );
+    }
+
+    [[eosio::action]]
+    void getposition( const name owner, const uint64_t pair_id, const uint64_t liquidity )
+    {
+        const auto position = hamburger::get_position( owner, pair_id, liquidity );
+        print( position.amount0 );
+        print( position.amount1 );
+    }
+
+    [[eosio::action]]
+    void addliquidity( const uint64_t pair_id, const asset desired0, const asset desired1 )
+    {
+        const auto [ amount0, amount1, liquidity ] = hamburger::quote_add_liquidity( pair_id, desired0, desired1 );
+        print( amount0 );
+        print( amount1 );
+        print( liquidity );
+    }
+
+    [[eosio::action]]
+    void rmliquidity( const uint64_t pair_id, const uint64_t liquidity )
+    {
+        const auto [ amount0, amount1 ] = hamburger::quote_remove_liquidity( pair_id, liquidity );
+        print( amount0 );
+        print( amount1 );
+    }
+
+    [[eosio::action]]
+    void getpools()
+    {
+        for ( const auto& pool : hamburger::get_pools_rewards() ) {
+            print( pool.pair_id );
+            print( pool.rate );
+            print( pool.rewards );
+        }
+    }
+
+    [[eosio::action]]
+    void getconfig()
+    {
+        hamburger::snapshot snapshot;
+        print( &snapshot.get_config() == &hamburger::get_config() );    // single cache
+        hamburger::invalidate_config();
+        print( snapshot.get_fee() );
+    }
+
+    [[eosio::action]]
+    void getstatus()
+    {
+        print( hamburger::is_trading_enabled() );
+        print( hamburger::is_mining_enabled() );
+    }
+
+    [[eosio::action]]
+    void twapupdate( const uint64_t pair_id )
+    {
+        hamburger::oracle oracle( get_self(), pair_id, 60, 6 );
+        oracle.update( get_self() );
+    }
+
+    [[eosio::action]]
+    void twapconsult( const uint64_t pair_id, const asset in )
+    {
+        hamburger::oracle oracle( get_self(), pair_id, 60, 6 );
+        print( oracle.consult( in ) );
+    }
+
+    [[eosio::action]]
+    void rankroutes( const asset in, const std::vector<std::vector<uint64_t>> routes, const asset hbg_price )
+    {
+        for ( const auto& route : hamburger::rank_routes( in, routes, hbg_price ) ) {
+            print( route.index );
+            print( route.out );
+            print( route.rewards );
+            print( route.net );
+        }
+    }
+
+#ifdef HAMBURGER_PROFILE
+    // helper counters, profiled build only (`eosio-cpp -DHAMBURGER_PROFILE`)
+    [[eosio::action]]
+    void getprofile( const uint64_t pair_id, const asset in )
+    {
+        const asset out = hamburger::get_amount_out( pair_id, in );
+        hamburger::get_rewards( pair_id, in, out );
+        hamburger::snapshot snapshot;
+        snapshot.get_reserves( pair_id, in.symbol );
+        snapshot.get_amount_out( pair_id, in );
+        hamburger::profile::print();
+    }
+#endif
+
     [[eosio::action]]
     void getfee() {
         const uint8_t fee = hamburger::get_fee();
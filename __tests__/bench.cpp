@@ -0,0 +1,186 @@
+#include <eosio/eosio.hpp>
+#include <eosio/system.hpp>
+
+#include <sx.hamburger/hamburger.hpp>
+
+using namespace eosio;
+
+/**
+ * Benchmark contract
+ *
+ * Deploy to `hamburgerswp` & `hbgtrademine` on a local node, seed mock rows
+ * and call `run` to invoke a helper K times within a single action.
+ * See `scripts/bench.sh` for the billed CPU report, `scripts/replay.sh` replays recorded rows & swaps.
+ */
+class [[eosio::contract]] bench : public contract {
+
+public:
+    using contract::contract;
+
+    /**
+     * Seed `config` & `pairs` (on `hamburgerswp`), EOS/T* pairs with ids 1..n
+     */
+    [[eosio::action]]
+    void seed( const uint64_t n )
+    {
+        require_auth( get_self() );
+
+        hamburger::global _global( get_self(), get_self().value );
+        _global.set( hamburger::global_row{}, get_self() );
+
+        hamburger::pairs _pairs( get_self(), get_self().value );
+        for ( uint64_t id = 1; id <= n; ++id ) {
+            if ( _pairs.find( id ) != _pairs.end() ) continue;
+            const symbol sym = token_symbol( id );
+            _pairs.emplace( get_self(), [&]( auto& row ) {
+                row.id = id;
+                row.code = symbol_code{"HBGLP"};
+                row.token0 = extended_symbol{ hamburger::EOS, "eosio.token"_n };
+                row.token1 = extended_symbol{ sym, "eosio.token"_n };
+                row.reserve0 = asset{ static_cast<int64_t>( 10000000 + id * 1000 ), hamburger::EOS };
+                row.reserve1 = asset{ static_cast<int64_t>( 26500000 + id * 777 ), sym };
+                row.total_liquidity = 1000000;
+                row.last_update_time = current_time_point().sec_since_epoch();
+                row.created_time = row.last_update_time;
+            });
+        }
+    }
+
+    /**
+     * Seed `pools` (on `hbgtrademine`) for pair ids 1..n
+     */
+    [[eosio::action]]
+    void seedpools( const uint64_t n )
+    {
+        require_auth( get_self() );
+
+        const uint32_t now = current_time_point().sec_since_epoch();
+        hamburger::pools _pools( get_self(), get_self().value );
+        for ( uint64_t id = 1; id <= n; ++id ) {
+            if ( _pools.find( id ) != _pools.end() ) continue;
+            _pools.emplace( get_self(), [&]( auto& row ) {
+                row.pair_id = id;
+                row.weight = 1.5;
+                row.balance = asset{ 1000000000, hamburger::HBG };
+                row.issued = asset{ 0, hamburger::HBG };
+                row.last_issue_time = now;
+                row.start_time = now;
+                row.end_time = now + 86400 * 30;
+            });
+        }
+    }
+
+    /**
+     * Invoke `helper` k times over pair ids 1..n
+     */
+    [[eosio::action]]
+    void run( const name helper, const uint64_t n, const uint32_t k )
+    {
+        const asset in = asset{ 10000, hamburger::EOS };
+        std::vector<std::pair<uint64_t, symbol>> many;
+        for ( uint64_t id = 1; id <= n; ++id ) many.push_back({ id, hamburger::EOS });
+
+        // checksum keeps the optimizer from dropping helper calls
+        int64_t checksum = 0;
+        for ( uint32_t i = 0; i < k; ++i ) {
+            const uint64_t pair_id = i % n + 1;
+            if ( helper == "noop"_n ) checksum += pair_id;
+            else if ( helper == "getfee"_n ) checksum += hamburger::get_fee();
+            else if ( helper == "getreserves"_n ) checksum += hamburger::get_reserves( pair_id, hamburger::EOS ).first.amount;
+            else if ( helper == "getreservest"_n ) checksum += hamburger::get_reserves<hamburger::EOS.raw()>( pair_id ).first.amount;
+            else if ( helper == "readreserves"_n ) checksum += hamburger::read_reserves( pair_id ).first.amount;
+            else if ( helper == "getmany"_n ) checksum += hamburger::get_reserves_many( many ).back().first.amount;
+            else if ( helper == "amountout"_n ) checksum += hamburger::get_amount_out( pair_id, in ).amount;
+            else if ( helper == "quotepath"_n ) checksum += hamburger::quote_path( in, { pair_id, pair_id } ).back().amount;
+            else if ( helper == "getrewards"_n ) checksum += hamburger::get_rewards( pair_id, in, asset{ 0, token_symbol( pair_id ) } ).amount;
+            else check( false, "unknown helper" );
+        }
+        print( checksum );
+    }
+
+    /**
+     * Invoke snapshot lookups k times over pair ids 1..n (shared cache)
+     */
+    [[eosio::action]]
+    void runsnapshot( const uint64_t n, const uint32_t k )
+    {
+        hamburger::snapshot snapshot;
+        const asset in = asset{ 10000, hamburger::EOS };
+
+        int64_t checksum = 0;
+        for ( uint32_t i = 0; i < k; ++i ) {
+            checksum += snapshot.get_amount_out( i % n + 1, in ).amount;
+        }
+        print( checksum );
+    }
+
+    /**
+     * Load recorded rows (`setconfig` & `setpair` on `hamburgerswp`, `setpool` on `hbgtrademine`)
+     */
+    [[eosio::action]]
+    void setconfig( const hamburger::global_row config )
+    {
+        require_auth( get_self() );
+        hamburger::global _global( get_self(), get_self().value );
+        _global.set( config, get_self() );
+    }
+
+    [[eosio::action]]
+    void setpair( const hamburger::pairs_row pair )
+    {
+        require_auth( get_self() );
+        hamburger::pairs _pairs( get_self(), get_self().value );
+        const auto itr = _pairs.find( pair.id );
+        if ( itr == _pairs.end() ) _pairs.emplace( get_self(), [&]( auto& row ) { row = pair; } );
+        else _pairs.modify( itr, get_self(), [&]( auto& row ) { row = pair; } );
+    }
+
+    [[eosio::action]]
+    void setpool( const hamburger::pools_row pool )
+    {
+        require_auth( get_self() );
+        hamburger::pools _pools( get_self(), get_self().value );
+        const auto itr = _pools.find( pool.pair_id );
+        if ( itr == _pools.end() ) _pools.emplace( get_self(), [&]( auto& row ) { row = pool; } );
+        else _pools.modify( itr, get_self(), [&]( auto& row ) { row = pool; } );
+    }
+
+    /**
+     * Replay one recorded swap: quote it with every helper (all must agree), print `out rewards now`
+     * and move the pair reserves like the swap did
+     */
+    [[eosio::action]]
+    void replayswap( const uint64_t pair_id, const asset in )
+    {
+        require_auth( get_self() );
+
+        const asset out = hamburger::get_amount_out( pair_id, in );
+        const auto [ reserve_in, reserve_out ] = hamburger::get_reserves( pair_id, in.symbol );
+        hamburger::snapshot snapshot;
+        check( snapshot.get_amount_out( pair_id, in ) == out, "replay: snapshot.get_amount_out diverges" );
+        check( hamburger::quote_path( in, { pair_id } ).back() == out, "replay: quote_path diverges" );
+        check( hamburger::get_reserves_many( { { pair_id, in.symbol } } )[0].first == reserve_in, "replay: get_reserves_many diverges" );
+        const auto& pair = snapshot.get_pair( pair_id );
+        check( hamburger::read_reserves( pair_id ) == std::pair<asset, asset>{ pair.reserve0, pair.reserve1 }, "replay: read_reserves diverges" );
+        check( static_cast<int64_t>( hamburger::get_amount_out( in.amount, reserve_in.amount, reserve_out.amount, hamburger::get_fee() ) ) == out.amount, "replay: get_amount_out diverges" );
+        const asset rewards = hamburger::get_rewards( pair_id, in, out );
+
+        const uint32_t now = current_time_point().sec_since_epoch();
+        hamburger::pairs _pairs( get_self(), get_self().value );
+        _pairs.modify( _pairs.find( pair_id ), get_self(), [&]( auto& row ) {
+            if ( row.reserve0.symbol == in.symbol ) { row.reserve0 += in; row.reserve1 -= out; }
+            else { row.reserve1 += in; row.reserve0 -= out; }
+            row.last_update_time = now;
+        });
+        print( out.amount, " ", rewards.amount, " ", now );
+    }
+
+private:
+    // T + base-26 letters of id, ex: 1 => "TB", 26 => "TBA"
+    static symbol token_symbol( uint64_t id )
+    {
+        std::string code = "T";
+        do { code += static_cast<char>( 'A' + id % 26 ); id /= 26; } while ( id );
+        return symbol{ code, 4 };
+    }
+};
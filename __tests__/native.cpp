@@ -0,0 +1,409 @@
+// native build: g++ -std=c++17 -pthread __tests__/native.cpp -I ../ -o native && ./native
+#include <sx.hamburger/math.hpp>
+#include <sx.hamburger/offchain/book.hpp>
+#include <sx.hamburger/offchain/book_file.hpp>
+#include <sx.hamburger/offchain/dex.hpp>
+#include <sx.hamburger/offchain/pair_store.hpp>
+#include <sx.hamburger/offchain/scanner.hpp>
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+// encode a get_blocks_result_v0 holding a single pairs row delta
+static std::vector<char> pairs_delta( const uint32_t block_num, const uint32_t lib, const hamburger::pair_state& pair, const bool present )
+{
+    hamburger::ship::writer row;
+    row.write<uint64_t>( pair.id );
+    row.write<uint64_t>( 0 );
+    row.write<uint64_t>( pair.symbol0 ); row.write<uint64_t>( pair.contract0 );
+    row.write<uint64_t>( pair.symbol1 ); row.write<uint64_t>( pair.contract1 );
+    row.write<int64_t>( pair.reserve0 ); row.write<uint64_t>( pair.symbol0 );
+    row.write<int64_t>( pair.reserve1 ); row.write<uint64_t>( pair.symbol1 );
+    row.write<uint64_t>( pair.total_liquidity );
+    row.write<uint32_t>( pair.last_update_time );
+    row.write<uint32_t>( 0 );
+
+    hamburger::ship::writer contract_row;
+    contract_row.write_varuint32( 0 );
+    for ( const uint64_t v : { hamburger::ship::code, hamburger::ship::code, hamburger::ship::pairs_table, pair.id, hamburger::ship::code } ) contract_row.write<uint64_t>( v );
+    contract_row.write_varuint32( row.data.size() );
+    contract_row.data.insert( contract_row.data.end(), row.data.begin(), row.data.end() );
+
+    hamburger::ship::writer deltas;
+    deltas.write_varuint32( 1 );
+    deltas.write_varuint32( 0 );
+    deltas.write_varuint32( 12 );
+    for ( const char c : std::string( "contract_row" ) ) deltas.write<char>( c );
+    deltas.write_varuint32( 1 );
+    deltas.write<uint8_t>( present );
+    deltas.write_varuint32( contract_row.data.size() );
+    deltas.data.insert( deltas.data.end(), contract_row.data.begin(), contract_row.data.end() );
+
+    hamburger::ship::writer w;
+    w.write_varuint32( 1 );
+    for ( const uint32_t num : { block_num, lib } ) { w.write<uint32_t>( num ); w.write( std::array<uint8_t, 32>{} ); }
+    w.write<uint8_t>( 1 ); w.write<uint32_t>( block_num ); w.write( std::array<uint8_t, 32>{} );
+    w.write<uint8_t>( 0 );
+    w.write<uint8_t>( 0 );
+    w.write<uint8_t>( 0 );
+    w.write<uint8_t>( 1 );
+    w.write_varuint32( deltas.data.size() );
+    w.data.insert( w.data.end(), deltas.data.begin(), deltas.data.end() );
+    return w.data;
+}
+
+int main()
+{
+    // amount out/in
+    assert( hamburger::get_amount_out( 10000, 45851931234, 125682033533, 30 ) == 27328 );
+    assert( hamburger::get_amount_in( 27328, 45851931234, 125682033533, 30 ) == 10000 );
+
+    // price impact
+    assert( hamburger::get_price_impact( 500000000, 45851931234, 30 ) == 108 );
+    assert( hamburger::get_price_impact( 1, 45851931234, 30 ) == 1 );
+
+    // amount to target price (price after x stays >= target, a little more crosses it)
+    {
+        const uint64_t r_in = 45851931234, r_out = 125682033533;
+        const uint64_t x = hamburger::get_amount_to_price( r_in, r_out, 27000, 10000, 30 );
+        const auto above = [&]( const uint64_t in ) {
+            const uint64_t out = hamburger::get_amount_out( in, r_in, r_out, 30 );
+            return static_cast<hamburger::uint128_t>( r_out - out ) * 10000 >= static_cast<hamburger::uint128_t>( 27000 ) * ( r_in + in );
+        };
+        assert( x == 347692266 && above( x ) && !above( x + 2 ) );
+        assert( hamburger::get_amount_to_price( r_in, r_out, 28000, 10000, 30 ) == 0 );
+        assert( hamburger::get_amount_to_price( 4000000000000000000, 4000000000000000000, 1, 2, 30 ) > 0 );
+    }
+
+    // liquidity share
+    assert( hamburger::get_share( 45851931234, 1000000, 75912498501 ) == 604010 );
+    assert( hamburger::get_share( 45851931234, 75912498501, 75912498501 ) == 45851931234 );
+
+    assert( hamburger::get_quote( 10000, 45851931234, 125682033533 ) == 27410 );
+    assert( hamburger::get_liquidity( 10000, 27410, 45851931234, 125682033533, 75912498501 ) == 16555 );
+    assert( hamburger::get_liquidity( 10000, 40000, 0, 0, 0 ) == 20000 );
+    assert( hamburger::get_share( 45851931234, 16555, 75912498501 ) == 9999 );
+
+    // twap math (price 2 for 100s, then 3 from update at t=100 => average 2.5 over [0, 200])
+    {
+        const hamburger::uint128_t two = hamburger::get_price( 10000, 20000 ), three = hamburger::get_price( 10000, 30000 );
+        const hamburger::uint128_t cumulative = hamburger::get_cumulative( 0, two, 0, three, 100, 200 );
+        assert( hamburger::get_price_amount( 10000, hamburger::get_average_price( 0, 0, cumulative, 200 ) ) == 25000 );
+        assert( hamburger::get_cumulative( cumulative, three, 200, three, 50, 210 ) == cumulative + three * 10 );
+        assert( hamburger::get_average_price( -three * 5, 0, three * 5, 10 ) == three );     // wraps
+        assert( hamburger::get_price_amount( 10000, hamburger::get_price( 45851931234, 125682033533 ) ) == 27410 );
+    }
+
+    // sort & quote plain pair
+    const hamburger::pair_state pair = { 12, 0x534f4504 /* 4,EOS */, 0x5444535504 /* 4,USDT */, 45851931234, 125682033533, 0, 0 };
+    assert( hamburger::sort_reserves( pair, pair.symbol1 ).first == 125682033533 );
+    assert( hamburger::get_amount_out( pair, pair.symbol0, 10000, hamburger::get_fee( hamburger::config_state{} ) ) == 27328 );
+
+    // status
+    assert( hamburger::is_trading_enabled( hamburger::config_state{} ) && !hamburger::is_mining_enabled( hamburger::config_state{ 1, 0 } ) );
+
+    // rewards (fixed-point vs floating point formula)
+    for ( int64_t amount = 10000; amount < 100000000000; amount *= 7 ) {
+        const int64_t balance = 1000000000;
+        const double total = balance + 1.5 * 0.005 * 60 * 1000000;
+        const int64_t expected = total - total * pow( 0.9999, amount / 10000 );
+        assert( std::abs( hamburger::get_rewards( balance, 1.5, 60, amount ) - expected ) <= 1 );
+    }
+    // rewards with large newsecs (weight not exactly representable in Q32)
+    for ( const double weight : { 0.1, 0.3, 1.5, 2.7 } ) {
+        for ( const uint32_t newsecs : { 1u << 20, 1u << 24, 1u << 28, 0xffffffffu } ) {
+            for ( const int64_t amount : { 10000ll, 123450000ll, 99990000000ll } ) {
+                const int64_t balance = 1000000000;
+                const long double total = balance + weight * 0.005L * newsecs * 1000000;      // extended precision reference
+                const int64_t expected = total - total * powl( 0.9999L, amount / 10000 );
+                assert( std::abs( hamburger::get_rewards( balance, weight, newsecs, amount ) - expected ) <= 1 );
+            }
+        }
+    }
+    const hamburger::pool_state pool = { 12, 1.5, 1000000000, 100, 0, 1000 };
+    assert( hamburger::get_rewards( pool, 160, 100000 ) == 999999 );
+    assert( hamburger::get_rewards( pool, 1001, 100000 ) == 0 );
+    assert( hamburger::is_active( pool, 0 ) && hamburger::is_active( pool, 1000 ) && !hamburger::is_active( pool, 1001 ) );
+    assert( hamburger::get_emission_rate( 1.5 ) == 7500 && hamburger::get_rewards( pool, 100, 10000 ) == 100000 );
+
+    // arbitrage
+    const auto [ in, profit ] = hamburger::get_arbitrage( 10000000000, 28000000000, 30, 125682033533, 45851931234, 30 );
+    assert( in == 62911930 && profit == 482251 );
+    assert( hamburger::get_arbitrage( 45851931234, 125682033533, 30, 28000000000, 10000000000, 30 ).first == 0 );
+
+    // ship deltas => reserve book (with fork rollback)
+    static_assert( hamburger::ship::to_name( "hamburgerswp" ) == 0x69a47d5d8abe3950 );
+    hamburger::offchain::reserve_book book;
+    const auto apply = [&]( const std::vector<char>& msg ) { book.apply( hamburger::ship::parse_blocks_result( msg.data(), msg.size() ) ); };
+    hamburger::pair_state next = pair;
+    apply( pairs_delta( 100, 90, pair, true ) );
+    next.reserve0 += 10000;
+    apply( pairs_delta( 101, 90, next, true ) );
+    assert( book.block_num() == 101 && book.get_pair( 12 )->reserve0 == pair.reserve0 + 10000 );
+    apply( pairs_delta( 101, 90, pair, false ) );       // fork replaces block 101
+    assert( book.block_num() == 101 && !book.get_pair( 12 ) );
+    apply( pairs_delta( 101, 100, pair, true ) );       // fork again, block 100 now irreversible
+    assert( book.get_pair( 12 )->reserve0 == pair.reserve0 && book.get_pair( 12 )->symbol1 == pair.symbol1 );
+
+    // lock-free pair reads while a writer republishes (reserves of one write, never torn)
+    {
+        uint32_t block_num = 0;
+        assert( book.get_pair( 12, &block_num ) && block_num == 101 && !book.get_pair( 5000000 ) );
+        hamburger::offchain::reserve_book live;
+        hamburger::pair_state p = pair;
+        p.reserve0 = 0;
+        p.reserve1 = pair.reserve0 + pair.reserve1;
+        live.set_pair( p );
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> readers;
+        for ( int t = 0; t < 4; ++t ) readers.emplace_back( [&]() {
+            while ( !done ) {
+                const auto read = live.get_pair( 12 );
+                assert( read && read->reserve0 + read->reserve1 == pair.reserve0 + pair.reserve1 && read->last_update_time == read->reserve0 );
+            }
+        });
+        for ( int i = 1; i <= 100000; ++i ) {
+            p.reserve0 = i;
+            p.reserve1 = pair.reserve0 + pair.reserve1 - i;
+            p.last_update_time = i;
+            live.set_pair( p );
+        }
+        done = true;
+        for ( std::thread& reader : readers ) reader.join();
+    }
+
+    // lock-free pool, config & block number reads while a writer republishes (one write each, never torn)
+    {
+        hamburger::offchain::reserve_book live;
+        assert( !live.get_pool( 12 ) && live.get_config().trade_fee == 20 && live.block_num() == 0 );
+        live.set_config( { 1, 0, 25, 5 } );
+        hamburger::pool_state p = pool;
+        std::atomic<bool> done{ false };
+        std::vector<std::thread> readers;
+        for ( int t = 0; t < 4; ++t ) readers.emplace_back( [&]() {
+            while ( !done ) {
+                const auto read = live.get_pool( 12 );
+                assert( !read || ( read->balance == read->last_issue_time && read->weight == read->balance * 0.5 ) );
+                uint32_t block_num = 0;
+                const hamburger::config_state config = live.get_config( &block_num );
+                assert( config.trade_fee + config.protocol_fee == 30 && live.block_num() >= block_num );
+            }
+        });
+        for ( int i = 1; i <= 100000; ++i ) {
+            p.balance = i;
+            p.last_issue_time = i;
+            p.weight = i * 0.5;
+            live.set_block_num( i );
+            live.set_pool( p );
+            live.set_config( { 1, 0, static_cast<uint8_t>( 30 - i % 30 ), static_cast<uint8_t>( i % 30 ) } );
+        }
+        done = true;
+        for ( std::thread& reader : readers ) reader.join();
+        uint32_t block_num = 0;
+        assert( live.get_pool( 12, &block_num )->balance == 100000 && block_num == 100000 );
+    }
+
+    // book file save => load (grows past initial capacity)
+    {
+        const char* path = "native_book.bin";
+        std::remove( path );
+        book.set_pool( pool );
+        hamburger::pair_state far = pair;
+        far.id = 40;
+        book.set_pair( far );
+        {
+            hamburger::offchain::book_file file( path, 16 );
+            assert( !file.load( book ) );
+            file.save( book );
+            assert( file.capacity() == 64 && file.block_num() == 101 );
+        }
+        hamburger::offchain::reserve_book restored;
+        hamburger::offchain::book_file file( path );
+        assert( file.load( restored ) && restored.block_num() == 101 );
+        assert( restored.get_pair( 12 )->reserve1 == pair.reserve1 && restored.get_pair( 40 )->contract1 == pair.contract1 );
+        assert( !restored.get_pair( 13 ) && restored.get_pool( 12 )->weight == 1.5 && restored.get_config().trade_fee == 20 );
+        std::remove( path );
+    }
+
+    // invalid book file throws without leaking the descriptor or mapping
+    {
+        const char* path = "native_invalid.bin";
+        FILE* f = fopen( path, "wb" );
+        for ( int i = 0; i < 128; ++i ) fputc( 'x', f );
+        fclose( f );
+        const int before = ::dup( 0 );
+        ::close( before );
+        bool thrown = false;
+        try { hamburger::offchain::book_file file( path ); }
+        catch ( const std::runtime_error& ) { thrown = true; }
+        const int after = ::dup( 0 );
+        ::close( after );
+        assert( thrown && before == after );
+        std::remove( path );
+    }
+
+    // cross-dex fetch & best route (hamburger book + another DEX)
+    {
+        const uint64_t HBG = 0x484247006;
+        hamburger::offchain::fetcher fetcher( {
+            std::make_shared<hamburger::offchain::hamburger_provider>( book ),
+            std::make_shared<hamburger::offchain::function_provider>( [&]() {
+                hamburger::offchain::market m;
+                m.dex = "defibox";
+                m.fee = 30;
+                m.pairs = { { 7, pair.symbol0, pair.symbol1, 10000000000, 28000000000 }, { 8, pair.symbol1, HBG, 50000000000, 9000000000000 } };
+                return m;
+            })
+        });
+        fetcher.refresh();
+        const auto markets = fetcher.latest();
+        assert( markets[0]->dex == "hamburger" && markets[0]->fee == 30 && markets[0]->block_num == 101 && markets[0]->pairs.size() == 2 );
+
+        const hamburger::offchain::token EOS{ pair.symbol0 }, USDT{ pair.symbol1 };
+        const auto direct = hamburger::offchain::best_route( markets, EOS, USDT, 10000 );
+        assert( direct.hops.size() == 1 && direct.hops[0].market == 1 && direct.hops[0].pair_id == 7 );
+        assert( direct.amount_out == hamburger::get_amount_out( 10000, 10000000000, 28000000000, 30 ) );
+
+        const auto cross = hamburger::offchain::best_route( markets, USDT, hamburger::offchain::token{ HBG }, 100000 );
+        assert( cross.hops.size() == 1 && cross.hops[0].pair_id == 8 && !cross.hops[0].reverse );
+        const auto two = hamburger::offchain::best_route( markets, EOS, hamburger::offchain::token{ HBG }, 10000 );
+        assert( two.hops.size() == 2 && two.hops[0].pair_id == 7 && two.hops[1].market == 1 );
+        const auto back = hamburger::offchain::best_route( markets, hamburger::offchain::token{ HBG }, EOS, 1000000000 );
+        assert( back.hops.size() == 2 && back.hops[0].reverse && back.hops[1].reverse && back.hops[1].market == 0 );
+        assert( hamburger::offchain::best_route( markets, EOS, hamburger::offchain::token{ 1 }, 10000 ).amount_out == 0 );
+
+        fetcher.start( std::chrono::milliseconds( 1 ) );
+        std::this_thread::sleep_for( std::chrono::milliseconds( 5 ) );
+        fetcher.stop();
+        assert( fetcher.latest()[1]->pairs.size() == 2 && fetcher.errors()[1].empty() );
+
+        // failing provider keeps its last market & reports the error, stop never waits out the interval
+        std::atomic<bool> down{ false };
+        hamburger::offchain::fetcher flaky( {
+            std::make_shared<hamburger::offchain::hamburger_provider>( book ),
+            std::make_shared<hamburger::offchain::function_provider>( [&]() {
+                if ( down ) throw std::runtime_error( "defibox: timeout" );
+                hamburger::offchain::market m;
+                m.dex = "defibox";
+                return m;
+            })
+        });
+        flaky.refresh();
+        down = true;
+        bool thrown = false;
+        try { flaky.refresh(); }
+        catch ( const std::runtime_error& ) { thrown = true; }
+        assert( thrown && flaky.errors()[0].empty() && flaky.errors()[1] == "defibox: timeout" && flaky.latest()[1]->dex == "defibox" );
+
+        const auto started = std::chrono::steady_clock::now();
+        flaky.start( std::chrono::hours( 1 ) );
+        thrown = false;
+        try { flaky.start( std::chrono::hours( 1 ) ); }
+        catch ( const std::logic_error& ) { thrown = true; }
+        assert( thrown );
+        flaky.stop();
+        assert( std::chrono::steady_clock::now() - started < std::chrono::seconds( 10 ) );
+        down = false;
+        flaky.refresh();
+        assert( flaky.errors()[1].empty() );
+    }
+
+    // pair store batch quote (vectorized screen vs exact)
+    {
+        hamburger::offchain::pair_store store( 30 );
+        for ( uint64_t id = 1; id <= 37; ++id ) {
+            hamburger::pair_state p = pair;
+            p.id = id;
+            p.reserve0 = pair.reserve0 / id;
+            p.reserve1 = id == 5 ? 0 : pair.reserve1 * id;
+            store.set( p );
+        }
+        std::vector<double> approx( store.size() );
+        std::vector<uint64_t> exact( store.size() );
+        store.quote_out( 10000, false, approx.data() );
+        store.quote_out_exact( 10000, false, exact.data() );
+        for ( size_t i = 0; i < store.size(); ++i ) assert( std::abs( approx[i] - exact[i] ) <= 1 );
+        assert( exact[0] == 27328 && exact[store.slot( 5 )] == 0 && store.precision1()[0] == 4 );
+    }
+
+    // cycle scanner (2-cycle EOS/USDT across two pairs, 3-cycle EOS => USDT => HBG => EOS)
+    {
+        const uint64_t EOS = 0x534f4504, USDT = 0x5444535504, HBG = 0x484247006;
+        const std::vector<hamburger::pair_state> pairs = {
+            { 1, EOS, USDT, 10000000000, 28000000000, 0, 0, 1, 2 },
+            { 2, EOS, USDT, 45851931234, 125682033533, 0, 0, 1, 2 },
+            { 3, USDT, HBG, 50000000000, 9000000000000, 0, 0, 2, 3 },
+            { 4, HBG, EOS, 3000000000000, 2000000000, 0, 0, 3, 1 },
+        };
+        hamburger::offchain::scanner scanner( 4 );
+        scanner.build( pairs, 30 );
+        assert( scanner.cycles() == 2 + 2 * 2 );
+        const auto found = scanner.scan();
+        assert( !found.empty() && std::is_sorted( found.begin(), found.end(), []( const auto& a, const auto& b ) { return a.profit > b.profit; } ) );
+
+        const auto two = std::find_if( found.begin(), found.end(), []( const auto& o ) { return o.hops == 2; } );
+        assert( two != found.end() && two->pair_ids[0] == 1 && two->pair_ids[1] == 2 && two->symbol == EOS );
+        assert( two->amount_in == 62911930 && two->profit == 482251 );
+
+        const auto three = std::find_if( found.begin(), found.end(), []( const auto& o ) { return o.hops == 3; } );
+        assert( three != found.end() );
+        const auto path_profit = [&]( const hamburger::offchain::opportunity& o, const uint64_t in ) {
+            uint64_t amount = in;
+            uint64_t token = o.symbol;
+            for ( uint8_t i = 0; i < o.hops; ++i ) {
+                const auto& p = pairs[o.pair_ids[i] - 1];
+                const bool reverse = p.symbol1 == token;
+                amount = hamburger::get_amount_out( amount, reverse ? p.reserve1 : p.reserve0, reverse ? p.reserve0 : p.reserve1, 30 );
+                token = reverse ? p.symbol0 : p.symbol1;
+            }
+            return static_cast<int64_t>( amount ) - static_cast<int64_t>( in );
+        };
+        assert( path_profit( *three, three->amount_in ) == static_cast<int64_t>( three->profit ) );
+        assert( path_profit( *three, three->amount_in * 99 / 100 ) <= static_cast<int64_t>( three->profit ) );
+        assert( path_profit( *three, three->amount_in * 101 / 100 ) <= static_cast<int64_t>( three->profit ) );
+        assert( scanner.scan( 1 ).size() == 1 && scanner.scan( 1 )[0].profit == found[0].profit );
+
+        // incremental: only the 3-cycles through pair 4 are re-evaluated
+        hamburger::pair_state hbg_eos = pairs[3];
+        assert( scanner.update( { hbg_eos } ) == 0 );
+        hbg_eos.reserve0 = hbg_eos.reserve1 = 0;    // removed pair (ex: `pairs` row erased)
+        assert( scanner.update( { hbg_eos } ) == 4 );
+        const auto after = scanner.best();
+        assert( std::none_of( after.begin(), after.end(), []( const auto& o ) { return o.hops == 3; } ) );
+        assert( after.size() == 1 && after[0].profit == 482251 );
+        std::vector<hamburger::pair_state> updated = pairs;
+        updated[3] = hbg_eos;
+        hamburger::offchain::scanner full( 1 );
+        full.build( updated, 30 );
+        assert( full.scan().size() == after.size() && full.scan()[0].amount_in == after[0].amount_in );
+        // hub graph (EOS in almost every cycle): chunked parallel scan matches a single thread
+        std::vector<hamburger::pair_state> hub;
+        for ( uint64_t t = 1; t <= 12; ++t ) {
+            const uint64_t token = ( 0x4100 + t ) << 8 | 4;
+            hub.push_back( { hub.size() + 1, EOS, token, 10000000000, static_cast<int64_t>( 20000000000 + t * 1000000000 ), 0, 0, 1, 9 } );
+            hub.push_back( { hub.size() + 1, token, EOS, static_cast<int64_t>( 21000000000 + t * 900000000 ), 10000000000, 0, 0, 9, 1 } );
+            if ( t > 1 ) hub.push_back( { hub.size() + 1, token, ( 0x4100 + t - 1 ) << 8 | 4, 10000000000, 10500000000, 0, 0, 9, 9 } );
+        }
+        hamburger::offchain::scanner single( 1 ), many( 8 );
+        single.build( hub, 30 );
+        many.build( hub, 30 );
+        assert( single.cycles() > 64 && single.cycles() == many.cycles() );
+        const auto expected = single.scan(), actual = many.scan();
+        assert( !expected.empty() && expected.size() == actual.size() );
+        for ( size_t i = 0; i < expected.size(); ++i ) assert( expected[i].profit == actual[i].profit );
+
+        hamburger::pair_state unknown = pairs[0];
+        unknown.id = 99;
+        assert( scanner.update( { unknown } ) == -1 );
+
+        // an unknown pair rejects the whole batch (known pairs of it are not applied)
+        hamburger::pair_state moved = pairs[0];
+        moved.reserve1 = 10000000000;
+        assert( scanner.update( { moved, unknown } ) == -1 );
+        assert( scanner.update( { moved } ) > 0 );
+    }
+
+    printf( "ok\n" );
+    return 0;
+}
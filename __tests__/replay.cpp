@@ -0,0 +1,160 @@
+// native build: g++ -std=c++17 -pthread -O2 __tests__/replay.cpp -I ../ -o replay
+// usage: ./replay <recording> <results>
+#include <sx.hamburger/math.hpp>
+#include <sx.hamburger/offchain/book.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * Off-chain mirror of a replay (see `scripts/replay.sh`)
+ *
+ * Applies the recording to a `reserve_book` in lockstep with the on-chain results (one `out rewards now cpu_us`
+ * line per swap), reports every divergence of amount out & HBG rewards, on-chain CPU percentiles and the
+ * mirror quotes/sec. Exits 1 on any divergence.
+ *
+ * Recording lines:
+ *
+ * config <contract_status> <mine_status> <trade_fee> <protocol_fee>
+ * pair <id> <contract0> <reserve0> <symbol0> <contract1> <reserve1> <symbol1> <total_liquidity> <last_update_time>
+ * pool <pair_id> <weight> <balance> <last_issue_time> <start_time> <end_time>
+ * swap <pair_id> <amount> <symbol>
+ */
+
+struct swap {
+    uint64_t    pair_id;
+    uint64_t    symbol;         // raw symbol of the input
+    int64_t     amount;
+};
+
+static uint64_t to_name( const std::string& str )
+{
+    return hamburger::ship::to_name( str.c_str() );
+}
+
+// "4585193.1234" + "EOS" => amount 45851931234 & raw symbol 4,EOS
+static std::pair<int64_t, uint64_t> to_asset( const std::string& amount, const std::string& code )
+{
+    const size_t dot = amount.find( '.' );
+    const uint8_t precision = dot == std::string::npos ? 0 : amount.size() - dot - 1;
+    std::string digits = amount;
+    if ( dot != std::string::npos ) digits.erase( dot, 1 );
+
+    uint64_t raw = 0;
+    for ( size_t i = 0; i < code.size(); ++i ) raw |= static_cast<uint64_t>( code[i] ) << ( 8 * ( i + 1 ) );
+    return { std::stoll( digits ), raw | precision };
+}
+
+static uint64_t percentile( std::vector<uint64_t> values, const double p )
+{
+    if ( values.empty() ) return 0;
+    std::sort( values.begin(), values.end() );
+    return values[std::min( values.size() - 1, static_cast<size_t>( p * values.size() ) )];
+}
+
+int main( int argc, char** argv )
+{
+    if ( argc < 3 ) {
+        fprintf( stderr, "usage: %s <recording> <results>\n", argv[0] );
+        return 2;
+    }
+    std::ifstream recording( argv[1] ), results( argv[2] );
+    const uint64_t EOS = to_asset( "0.0000", "EOS" ).second;
+
+    hamburger::offchain::reserve_book book;
+    std::map<uint64_t, hamburger::pool_state> pools;
+    std::vector<swap> swaps;
+    std::vector<uint64_t> cpu;
+    size_t divergences = 0;
+
+    std::string line;
+    while ( std::getline( recording, line ) ) {
+        std::istringstream in( line );
+        std::string type;
+        if ( !( in >> type ) || type[0] == '#' ) continue;
+
+        if ( type == "config" ) {
+            int status, mine_status, trade_fee, protocol_fee;
+            in >> status >> mine_status >> trade_fee >> protocol_fee;
+            book.set_config( { static_cast<uint8_t>( status ), static_cast<uint8_t>( mine_status ), static_cast<uint8_t>( trade_fee ), static_cast<uint8_t>( protocol_fee ) } );
+        }
+        else if ( type == "pair" ) {
+            hamburger::pair_state pair;
+            std::string contract0, amount0, symbol0, contract1, amount1, symbol1;
+            in >> pair.id >> contract0 >> amount0 >> symbol0 >> contract1 >> amount1 >> symbol1 >> pair.total_liquidity >> pair.last_update_time;
+            std::tie( pair.reserve0, pair.symbol0 ) = to_asset( amount0, symbol0 );
+            std::tie( pair.reserve1, pair.symbol1 ) = to_asset( amount1, symbol1 );
+            pair.contract0 = to_name( contract0 );
+            pair.contract1 = to_name( contract1 );
+            book.set_pair( pair );
+        }
+        else if ( type == "pool" ) {
+            hamburger::pool_state pool;
+            std::string balance;
+            in >> pool.pair_id >> pool.weight >> balance >> pool.last_issue_time >> pool.start_time >> pool.end_time;
+            pool.balance = to_asset( balance, "HBG" ).first;
+            pools[pool.pair_id] = pool;
+        }
+        else if ( type == "swap" ) {
+            swap s;
+            std::string amount, code;
+            in >> s.pair_id >> amount >> code;
+            std::tie( s.amount, s.symbol ) = to_asset( amount, code );
+
+            int64_t out = 0, rewards = 0;
+            uint32_t now = 0;
+            uint64_t cpu_us = 0;
+            if ( !( results >> out >> rewards >> now >> cpu_us ) ) {
+                fprintf( stderr, "missing result of swap %zu\n", swaps.size() + 1 );
+                return 1;
+            }
+            swaps.push_back( s );
+            cpu.push_back( cpu_us );
+
+            // mirror quote (same formulas as the helpers) then move the reserves
+            hamburger::pair_state pair = book.get_pair( s.pair_id ).value_or( hamburger::pair_state{ s.pair_id } );
+            const hamburger::config_state config = book.get_config();
+            const int64_t expected = pair.reserve0 > 0 ? hamburger::get_amount_out( pair, s.symbol, s.amount, hamburger::get_fee( config ) ) : 0;
+            const uint64_t symbol_out = pair.symbol0 == s.symbol ? pair.symbol1 : pair.symbol0;
+            const auto pool = pools.find( s.pair_id );
+            const int64_t eos = s.symbol == EOS ? s.amount : symbol_out == EOS ? expected : 0;
+            const int64_t expected_rewards = hamburger::is_mining_enabled( config ) && eos && pool != pools.end() ? hamburger::get_rewards( pool->second, now, eos ) : 0;
+
+            if ( expected != out || expected_rewards != rewards ) {
+                ++divergences;
+                printf( "divergence swap %zu pair %llu: out %lld (mirror %lld), rewards %lld (mirror %lld)\n", swaps.size(),
+                    (unsigned long long) s.pair_id, (long long) out, (long long) expected, (long long) rewards, (long long) expected_rewards );
+            }
+            if ( pair.symbol0 == s.symbol ) { pair.reserve0 += s.amount; pair.reserve1 -= out; }
+            else { pair.reserve1 += s.amount; pair.reserve0 -= out; }
+            pair.last_update_time = now;
+            book.set_pair( pair );
+        }
+    }
+
+    // mirror throughput: re-quote every recorded swap against the final book for ~200ms
+    const uint8_t fee = hamburger::get_fee( book.get_config() );
+    uint64_t quotes = 0, checksum = 0;
+    const auto start = std::chrono::steady_clock::now();
+    std::chrono::duration<double> elapsed{ 0 };
+    while ( !swaps.empty() && elapsed.count() < 0.2 ) {
+        for ( const swap& s : swaps ) {
+            const auto pair = book.get_pair( s.pair_id );
+            if ( pair && pair->reserve0 > 0 ) checksum += hamburger::get_amount_out( *pair, s.symbol, s.amount, fee );
+        }
+        quotes += swaps.size();
+        elapsed = std::chrono::steady_clock::now() - start;
+    }
+
+    printf( "swaps        %zu\n", swaps.size() );
+    printf( "divergences  %zu\n", divergences );
+    printf( "cpu_us       p50 %llu  p90 %llu  p99 %llu  max %llu\n", (unsigned long long) percentile( cpu, 0.5 ), (unsigned long long) percentile( cpu, 0.9 ),
+        (unsigned long long) percentile( cpu, 0.99 ), (unsigned long long) percentile( cpu, 1.0 ) );
+    printf( "mirror       %.0f quotes/sec (checksum %llu)\n", elapsed.count() > 0 ? quotes / elapsed.count() : 0.0, (unsigned long long) checksum );
+    return divergences ? 1 : 0;
+}
@@ -1,8 +1,18 @@
 #pragma once
 
+#include <eosio/multi_index.hpp>
 #include <eosio/singleton.hpp>
 #include <eosio/asset.hpp>
 
+#include "math.hpp"
+#include "profile.hpp"
+
+#include <algorithm>
+#include <map>
+#include <optional>
+#include <tuple>
+#include <vector>
+
 namespace hamburger {
 
     using eosio::asset;
@@ -13,10 +23,14 @@ namespace hamburger {
     using eosio::multi_index;
     using eosio::time_point_sec;
 
-    const name id = "hamburger"_n;
-    const name code = "hamburgerswp"_n;
+    static constexpr name id = "hamburger"_n;
+    static constexpr name code = "hamburgerswp"_n;
+    static constexpr name mine_code = "hbgtrademine"_n;
     const std::string description = "Hamburger Converter";
 
+    static constexpr symbol EOS = symbol{"EOS", 4};
+    static constexpr symbol HBG = symbol{"HBG", 6};
+
     /**
      * Hamburger pairs
      */
@@ -35,6 +49,110 @@ namespace hamburger {
     };
     typedef eosio::multi_index< "pairs"_n, pairs_row > pairs;
 
+    /**
+     * Fixed-width pair reserves for inter-contract payloads (31 bytes packed, no symbols)
+     */
+    struct reserve_snapshot {
+        uint64_t            pair_id;
+        int64_t             reserve0;
+        int64_t             reserve1;
+        uint8_t             precision0;
+        uint8_t             precision1;
+        uint8_t             fee;
+        uint32_t            timestamp;          // pair `last_update_time`
+
+        static constexpr uint32_t packed_size = 8 + 8 + 8 + 1 + 1 + 1 + 4;
+    };
+
+    /**
+     * ## STATIC `to_snapshot`
+     *
+     * Convert a pair row to a compact reserve snapshot
+     *
+     * ### params
+     *
+     * - `{pairs_row} pair` - pair row
+     * - `{uint8_t} fee` - total fee (ex: `get_fee()`)
+     *
+     * ### returns
+     *
+     * - `{reserve_snapshot}` - snapshot
+     */
+    static reserve_snapshot to_snapshot( const pairs_row& pair, const uint8_t fee )
+    {
+        return { pair.id, pair.reserve0.amount, pair.reserve1.amount, pair.reserve0.symbol.precision(), pair.reserve1.symbol.precision(), fee, pair.last_update_time };
+    }
+
+    /**
+     * ## STATIC `pack`
+     *
+     * Serialize reserve snapshots back to back (`reserve_snapshot::packed_size` bytes each)
+     *
+     * ### params
+     *
+     * - `{vector<reserve_snapshot>} snapshots` - snapshots
+     *
+     * ### returns
+     *
+     * - `{vector<char>}` - packed bytes
+     */
+    static std::vector<char> pack( const std::vector<reserve_snapshot>& snapshots )
+    {
+        std::vector<char> res( snapshots.size() * reserve_snapshot::packed_size );
+        eosio::datastream<char*> ds( res.data(), res.size() );
+        for ( const reserve_snapshot& s : snapshots ) {
+            ds << s.pair_id << s.reserve0 << s.reserve1 << s.precision0 << s.precision1 << s.fee << s.timestamp;
+        }
+        return res;
+    }
+
+    /**
+     * ## STATIC `unpack`
+     *
+     * Deserialize reserve snapshots packed by `pack`
+     *
+     * ### params
+     *
+     * - `{vector<char>} data` - packed bytes
+     *
+     * ### returns
+     *
+     * - `{vector<reserve_snapshot>}` - snapshots
+     */
+    static std::vector<reserve_snapshot> unpack( const std::vector<char>& data )
+    {
+        eosio::check( data.size() % reserve_snapshot::packed_size == 0, "HamburgerLibrary: INVALID_SNAPSHOT" );
+
+        std::vector<reserve_snapshot> res( data.size() / reserve_snapshot::packed_size );
+        eosio::datastream<const char*> ds( data.data(), data.size() );
+        for ( reserve_snapshot& s : res ) {
+            ds >> s.pair_id >> s.reserve0 >> s.reserve1 >> s.precision0 >> s.precision1 >> s.fee >> s.timestamp;
+        }
+        return res;
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Quote output of a reserve snapshot (no table access)
+     *
+     * ### params
+     *
+     * - `{reserve_snapshot} snapshot` - snapshot
+     * - `{bool} reverse` - true if trading from reserve1
+     * - `{uint64_t} amount_in` - amount input
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount out
+     */
+    static uint64_t get_amount_out( const reserve_snapshot& snapshot, const bool reverse, const uint64_t amount_in )
+    {
+        return reverse ?
+            get_amount_out( amount_in, snapshot.reserve1, snapshot.reserve0, snapshot.fee ) :
+            get_amount_out( amount_in, snapshot.reserve0, snapshot.reserve1, snapshot.fee );
+    }
+
     /**
      * Defibox config
      */
@@ -74,6 +192,93 @@ namespace hamburger {
     };
     typedef eosio::multi_index< "pools"_n, pools_row > pools;
 
+    /**
+     * ## STATIC `to_state`
+     *
+     * Convert table rows to their plain `math.hpp` mirrors
+     *
+     * ### params
+     *
+     * - `{pairs_row|global_row|deposits_row|pools_row} row` - table row
+     *
+     * ### returns
+     *
+     * - `{pair_state|config_state|deposit_state|pool_state}` - plain struct
+     */
+    static pair_state to_state( const pairs_row& row )
+    {
+        return { row.id, row.reserve0.symbol.raw(), row.reserve1.symbol.raw(), row.reserve0.amount, row.reserve1.amount, row.total_liquidity, row.last_update_time, row.token0.get_contract().value, row.token1.get_contract().value };
+    }
+
+    static config_state to_state( const global_row& row )
+    {
+        return { row.contract_status, row.mine_status, row.trade_fee, row.protocol_fee };
+    }
+
+    static deposit_state to_state( const deposits_row& row )
+    {
+        return { row.owner.value, row.quantity0.symbol.raw(), row.quantity0.amount, row.quantity1.symbol.raw(), row.quantity1.amount };
+    }
+
+    static pool_state to_state( const pools_row& row )
+    {
+        return { row.pair_id, row.weight, row.balance.amount, row.last_issue_time, row.start_time, row.end_time };
+    }
+
+    // action-wide config cache shared by every helper & `snapshot`
+    static std::optional<global_row>& config_cache()
+    {
+        static std::optional<global_row> config;
+        return config;
+    }
+
+    /**
+     * ## STATIC `get_config`
+     *
+     * Get config (read once per action, later calls are served from the cache until `invalidate_config`)
+     *
+     * ### returns
+     *
+     * - `{global_row}` - config
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto config = hamburger::get_config();
+     * // config.trade_fee => 20
+     * ```
+     */
+    static const global_row& get_config()
+    {
+        HAMBURGER_PROFILE_CALL( get_config );
+        std::optional<global_row>& config = config_cache();
+        if ( !config ) {
+            HAMBURGER_PROFILE_DB_READ( get_config );
+            hamburger::global _global( code, code.value );
+            config = _global.get_or_default();
+        }
+        else HAMBURGER_PROFILE_CACHE_HIT( get_config );
+        return *config;
+    }
+
+    /**
+     * ## STATIC `invalidate_config`
+     *
+     * Drop the cached config (ex: after sending an inline action that changes it), the next helper reads it again
+     *
+     * ### example
+     *
+     * ```c++
+     * hamburger::invalidate_config();
+     * const uint8_t fee = hamburger::get_fee();
+     * // => fee of the current `config` row
+     * ```
+     */
+    static void invalidate_config()
+    {
+        config_cache().reset();
+    }
+
     /**
      * ## STATIC `get_fee`
      *
@@ -92,10 +297,152 @@ namespace hamburger {
      */
     static uint8_t get_fee()
     {
-        //return 30;
-        hamburger::global _global( "hamburgerswp"_n, "hamburgerswp"_n.value );
-        hamburger::global_row global = _global.get_or_default();
-        return global.trade_fee + global.protocol_fee;
+        HAMBURGER_PROFILE_CALL( get_fee );
+        return get_fee( to_state( get_config() ) );
+    }
+
+    /**
+     * ## STATIC `is_trading_enabled`
+     *
+     * Check if Hamburger swaps are enabled (`contract_status`), shares the `get_config` cache
+     *
+     * ### returns
+     *
+     * - `{bool}` - true if enabled
+     *
+     * ### example
+     *
+     * ```c++
+     * if ( !hamburger::is_trading_enabled() ) return; // skip inline swap
+     * ```
+     */
+    static bool is_trading_enabled()
+    {
+        HAMBURGER_PROFILE_CALL( is_trading_enabled );
+        return is_trading_enabled( to_state( get_config() ) );
+    }
+
+    /**
+     * ## STATIC `is_mining_enabled`
+     *
+     * Check if HBG trade mining is enabled (`mine_status`), shares the `get_config` cache
+     *
+     * ### returns
+     *
+     * - `{bool}` - true if enabled
+     *
+     * ### example
+     *
+     * ```c++
+     * const bool mining = hamburger::is_mining_enabled();
+     * // => true
+     * ```
+     */
+    static bool is_mining_enabled()
+    {
+        HAMBURGER_PROFILE_CALL( is_mining_enabled );
+        return is_mining_enabled( to_state( get_config() ) );
+    }
+
+    /**
+     * ## STATIC `sort_reserves`
+     *
+     * Sort reserves of a pair row
+     *
+     * ### params
+     *
+     * - `{pairs_row|pair<asset, asset>} pairs` - pair row or reserves in table order
+     * - `{symbol} sort` - sort by symbol (reserve0 will be first item in pair)
+     *
+     * ### returns
+     *
+     * - `{pair<asset, asset>}` - pair of reserve assets
+     */
+    static std::pair<asset, asset> sort_reserves( const std::pair<asset, asset>& reserves, const symbol sort )
+    {
+        const auto& [ reserve0, reserve1 ] = reserves;
+        eosio::check( reserve0.symbol == sort || reserve1.symbol == sort, "sort symbol does not match" );
+
+        return sort == reserve0.symbol ?
+            std::pair<asset, asset>{ reserve0, reserve1 } :
+            std::pair<asset, asset>{ reserve1, reserve0 };
+    }
+
+    static std::pair<asset, asset> sort_reserves( const pairs_row& pairs, const symbol sort )
+    {
+        return sort_reserves( { pairs.reserve0, pairs.reserve1 }, sort );
+    }
+
+    /**
+     * ## STATIC `sort_reserves<sort>`
+     *
+     * Sort reserves of a pair row by a compile-time symbol
+     *
+     * ### params
+     *
+     * - `{uint64_t} sort` - template parameter, raw value of sort symbol (ex: `hamburger::EOS.raw()`)
+     * - `{pairs_row|pair<asset, asset>} pairs` - pair row or reserves in table order
+     *
+     * ### returns
+     *
+     * - `{pair<asset, asset>}` - pair of reserve assets
+     */
+    template <uint64_t sort>
+    static std::pair<asset, asset> sort_reserves( const std::pair<asset, asset>& reserves )
+    {
+        const auto& [ reserve0, reserve1 ] = reserves;
+        if ( reserve0.symbol.raw() == sort ) return { reserve0, reserve1 };
+        eosio::check( reserve1.symbol.raw() == sort, "sort symbol does not match" );
+        return { reserve1, reserve0 };
+    }
+
+    template <uint64_t sort>
+    static std::pair<asset, asset> sort_reserves( const pairs_row& pairs )
+    {
+        return sort_reserves<sort>( { pairs.reserve0, pairs.reserve1 } );
+    }
+
+    /**
+     * ## STATIC `read_reserves`
+     *
+     * Read reserves of a pair straight from the database (no multi_index object cache, no full row decoding)
+     *
+     * `pairs_row` packs to a fixed layout, `reserve0` & `reserve1` are decoded at their known offset.
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     *
+     * ### returns
+     *
+     * - `{pair<asset, asset>}` - pair of reserve assets (table order)
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto [reserve0, reserve1] = hamburger::read_reserves( 12 );
+     * // reserve0 => "4585193.1234 EOS"
+     * // reserve1 => "12568203.3533 USDT"
+     * ```
+     */
+    static std::pair<asset, asset> read_reserves( const uint64_t pair_id )
+    {
+        using namespace eosio::internal_use_do_not_use;
+        HAMBURGER_PROFILE_CALL( read_reserves );
+        HAMBURGER_PROFILE_DB_READ( read_reserves );
+
+        const int32_t itr = db_find_i64( code.value, code.value, "pairs"_n.value, pair_id );
+        eosio::check( itr >= 0, "HamburgerLibrary: INVALID_PAIR_ID" );
+
+        // id (8) + code (8) + token0 (16) + token1 (16) precede reserve0 (16) + reserve1 (16)
+        constexpr uint32_t offset = 48;
+        char buffer[offset + 32];
+        eosio::check( db_get_i64( itr, buffer, sizeof( buffer ) ) >= static_cast<int32_t>( sizeof( buffer ) ), "HamburgerLibrary: INVALID_PAIR_ROW" );
+
+        std::pair<asset, asset> reserves;
+        eosio::datastream<const char*> ds( buffer + offset, 32 );
+        ds >> reserves.first >> reserves.second;
+        return reserves;
     }
 
     /**
@@ -125,64 +472,980 @@ namespace hamburger {
      */
     static std::pair<asset, asset> get_reserves( const uint64_t pair_id, const symbol sort )
     {
-        // table
-        hamburger::pairs _pairs( "hamburgerswp"_n, "hamburgerswp"_n.value );
-        auto pairs = _pairs.get( pair_id, "HamburgerLibrary: INVALID_PAIR_ID" );
-        eosio::check( pairs.reserve0.symbol == sort || pairs.reserve1.symbol == sort, "sort symbol does not match" );
-
-        return sort == pairs.reserve0.symbol ?
-            std::pair<asset, asset>{ pairs.reserve0, pairs.reserve1 } :
-            std::pair<asset, asset>{ pairs.reserve1, pairs.reserve0 };
+        HAMBURGER_PROFILE_CALL( get_reserves );
+        return sort_reserves( read_reserves( pair_id ), sort );
     }
 
     /**
-     * ## STATIC `get_rewards`
+     * ## STATIC `get_reserves<sort>`
      *
-     * Get rewards for trading
+     * Get reserves for a pair sorted by a compile-time symbol
      *
      * ### params
      *
+     * - `{uint64_t} sort` - template parameter, raw value of sort symbol (ex: `hamburger::EOS.raw()`)
      * - `{uint64_t} pair_id` - pair id
-     * - `{asset} from` - tokens we are trading from
-     * - `{asset} to` - tokens we are trading to
      *
      * ### returns
      *
-     * - {asset} = rewards in BOX
+     * - `{pair<asset, asset>}` - pair of reserve assets
      *
      * ### example
      *
      * ```c++
-     * const uint64_t pair_id = 12;
-     * const asset from = asset{10000, {"EOS", 4}};
-     * const asset to = asset{12345, {"USDT", 4}};
-     *
-     * const auto rewards = hamburger::get_rewards( pair_id, from, to);
-     * // rewards => "0.123456 BOX"
+     * const auto [reserve0, reserve1] = hamburger::get_reserves<hamburger::EOS.raw()>( 12 );
+     * // reserve0 => "4585193.1234 EOS"
+     * // reserve1 => "12568203.3533 USDT"
      * ```
      */
+    template <uint64_t sort>
+    static std::pair<asset, asset> get_reserves( const uint64_t pair_id )
+    {
+        HAMBURGER_PROFILE_CALL( get_reserves );
+        return sort_reserves<sort>( read_reserves( pair_id ) );
+    }
 
-    static asset get_rewards( const uint64_t pair_id, asset in, asset out )
+    /**
+     * ## STATIC `get_reserves_many`
+     *
+     * Get reserves for many pairs using a single table handle
+     *
+     * ### params
+     *
+     * - `{vector<pair<uint64_t, symbol>>} pairs` - list of pair id & sort symbol
+     *
+     * ### returns
+     *
+     * - `{vector<pair<asset, asset>>}` - pairs of reserve assets (same order as requested)
+     *
+     * ### example
+     *
+     * ```c++
+     * const std::vector<std::pair<uint64_t, symbol>> pairs = {{ 12, symbol{"EOS", 4} }, { 1, symbol{"EOS", 4} }};
+     *
+     * const auto reserves = hamburger::get_reserves_many( pairs );
+     * // reserves[0] => ["4585193.1234 EOS", "12568203.3533 USDT"]
+     * // reserves[1] => ["1000.0000 EOS", "2650.0000 USDT"]
+     * ```
+     */
+    static std::vector<std::pair<asset, asset>> get_reserves_many( const std::vector<std::pair<uint64_t, symbol>>& pairs )
     {
-        asset res {0, symbol{"HBG",6}};
-        if(in.symbol != symbol{"EOS",4}) std::swap(in, out);
-        if(in.symbol != symbol{"EOS",4})
-            return res;     //return 0 if non-EOS pair
+        HAMBURGER_PROFILE_CALL( get_reserves_many );
 
+        // table
+        hamburger::pairs _pairs( code, code.value );
 
-        hamburger::pools _pools( "hbgtrademine"_n, "hbgtrademine"_n.value );
-        auto poolit = _pools.find( pair_id );
-        if(poolit==_pools.end()) return res;
+        // visit ids in ascending order so repeated & adjacent ids reuse the iterator
+        std::vector<uint32_t> order( pairs.size() );
+        for ( uint32_t i = 0; i < order.size(); ++i ) order[i] = i;
+        std::sort( order.begin(), order.end(), [&]( const uint32_t a, const uint32_t b ) {
+            return pairs[a].first < pairs[b].first;
+        });
 
-        auto now = eosio::current_time_point().sec_since_epoch();
+        std::vector<std::pair<asset, asset>> res( pairs.size() );
+        auto itr = _pairs.end();
+        for ( const uint32_t i : order ) {
+            const uint64_t pair_id = pairs[i].first;
+            if ( itr != _pairs.end() && itr->id == pair_id ) HAMBURGER_PROFILE_CACHE_HIT( get_reserves_many );
+            if ( itr != _pairs.end() && itr->id + 1 == pair_id ) { HAMBURGER_PROFILE_DB_READ( get_reserves_many ); ++itr; }
+            if ( itr == _pairs.end() || itr->id != pair_id ) { HAMBURGER_PROFILE_DB_READ( get_reserves_many ); itr = _pairs.find( pair_id ); }
+            eosio::check( itr != _pairs.end(), "HamburgerLibrary: INVALID_PAIR_ID" );
+
+            res[i] = sort_reserves( *itr, pairs[i].second );
+        }
+        return res;
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Quote output of a pair with a single pair lookup (the fee comes from the action-wide `get_config` cache)
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{asset} in` - tokens we are trading from
+     *
+     * ### returns
+     *
+     * - `{asset}` - tokens we receive
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset out = hamburger::get_amount_out( 12, asset{10000, symbol{"EOS", 4}} );
+     * // => "2.7328 USDT"
+     * ```
+     */
+    static asset get_amount_out( const uint64_t pair_id, const asset in )
+    {
+        HAMBURGER_PROFILE_CALL( get_amount_out );
+        const auto [ reserve_in, reserve_out ] = sort_reserves( read_reserves( pair_id ), in.symbol );
+
+        const uint64_t amount_out = get_amount_out( in.amount, reserve_in.amount, reserve_out.amount, get_fee() );
+        return { static_cast<int64_t>( amount_out ), reserve_out.symbol };
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Quote required input of a pair with a single pair lookup (the fee comes from the action-wide `get_config` cache)
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{asset} out` - tokens we want to receive
+     *
+     * ### returns
+     *
+     * - `{asset}` - tokens we are trading from
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset in = hamburger::get_amount_in( 12, asset{27328, symbol{"USDT", 4}} );
+     * // => "1.0000 EOS"
+     * ```
+     */
+    static asset get_amount_in( const uint64_t pair_id, const asset out )
+    {
+        HAMBURGER_PROFILE_CALL( get_amount_in );
+        const auto [ reserve_out, reserve_in ] = sort_reserves( read_reserves( pair_id ), out.symbol );
+
+        const uint64_t amount_in = get_amount_in( out.amount, reserve_in.amount, reserve_out.amount, get_fee() );
+        return { static_cast<int64_t>( amount_in ), reserve_in.symbol };
+    }
+
+    /**
+     * Quote with price impact (prices as Q64.64 output per input)
+     */
+    struct impact_quote {
+        asset           out;                // amount out
+        asset           min_out;            // amount out less slippage tolerance
+        uint128_t       mid_price;          // reserve_out / reserve_in before the trade
+        uint128_t       execution_price;    // out / in
+        uint64_t        impact;             // price impact excluding fee (basis points)
+    };
+
+    /**
+     * ## STATIC `quote_with_impact`
+     *
+     * Quote output of a pair with mid & execution prices and price impact, from a single pair lookup
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{asset} in` - tokens we are trading from
+     * - `{uint64_t} [slippage=0]` - slippage tolerance for `min_out` (basis points)
+     *
+     * ### returns
+     *
+     * - `{impact_quote}` - quote
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto quote = hamburger::quote_with_impact( 12, asset{500000000, symbol{"EOS", 4}}, 50 );
+     * // quote.out => "135171.3286 USDT"
+     * // quote.min_out => "134495.4719 USDT"
+     * // quote.impact => 108
+     * ```
+     */
+    static impact_quote quote_with_impact( const uint64_t pair_id, const asset in, const uint64_t slippage = 0 )
+    {
+        eosio::check( slippage <= 10000, "HamburgerLibrary: INVALID_SLIPPAGE" );
+        const auto [ reserve_in, reserve_out ] = sort_reserves( read_reserves( pair_id ), in.symbol );
+        const uint8_t fee = get_fee();
+
+        const uint64_t out = get_amount_out( in.amount, reserve_in.amount, reserve_out.amount, fee );
+        const uint64_t min_out = static_cast<uint128_t>( out ) * ( 10000 - slippage ) / 10000;
+        return {
+            asset{ static_cast<int64_t>( out ), reserve_out.symbol },
+            asset{ static_cast<int64_t>( min_out ), reserve_out.symbol },
+            get_price( reserve_in.amount, reserve_out.amount ),
+            ( static_cast<uint128_t>( out ) << 64 ) / static_cast<uint64_t>( in.amount ),
+            get_price_impact( in.amount, reserve_in.amount, fee )
+        };
+    }
+
+    /**
+     * ## STATIC `get_amount_to_price`
+     *
+     * Get the maximum input moving a pair spot price down to a target price (closed form, single pair lookup)
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{symbol} sort` - symbol of tokens we are trading from
+     * - `{asset} price` - target price in tokens we receive per 1 unit of `sort` (ex: "2.7000 USDT" per 1.0000 EOS)
+     *
+     * ### returns
+     *
+     * - `{asset}` - tokens we are trading from (zero if the price is already at or below target)
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset in = hamburger::get_amount_to_price( 12, symbol{"EOS", 4}, asset{27000, symbol{"USDT", 4}} );
+     * // => "34769.2266 EOS"
+     * ```
+     */
+    static asset get_amount_to_price( const uint64_t pair_id, const symbol sort, const asset price )
+    {
+        const auto [ reserve_in, reserve_out ] = sort_reserves( read_reserves( pair_id ), sort );
+        eosio::check( price.symbol == reserve_out.symbol, "HamburgerLibrary: INVALID_SYMBOL" );
+
+        uint64_t unit = 1;
+        for ( uint8_t i = 0; i < sort.precision(); ++i ) unit *= 10;
+
+        const uint64_t amount_in = get_amount_to_price( reserve_in.amount, reserve_out.amount, price.amount, unit, get_fee() );
+        return { static_cast<int64_t>( amount_in ), sort };
+    }
+
+    /**
+     * ## STATIC `pair_key`
+     *
+     * Get order independent lookup key of two tokens
+     *
+     * ### params
+     *
+     * - `{extended_symbol} token0` - first token
+     * - `{extended_symbol} token1` - second token
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - 64-bit key (same value for both token orders)
+     *
+     * ### example
+     *
+     * ```c++
+     * constexpr extended_symbol EOS = {{"EOS", 4}, "eosio.token"_n};
+     * constexpr extended_symbol USDT = {{"USDT", 4}, "tethertether"_n};
+     *
+     * constexpr uint64_t key = hamburger::pair_key( EOS, USDT );
+     * static_assert( key == hamburger::pair_key( USDT, EOS ) );
+     * ```
+     */
+    static constexpr uint64_t pair_key( const extended_symbol token0, const extended_symbol token1 )
+    {
+        // splitmix64 finalizer
+        constexpr auto mix = []( uint64_t x ) {
+            x = ( x ^ ( x >> 30 ) ) * 0xbf58476d1ce4e5b9;
+            x = ( x ^ ( x >> 27 ) ) * 0x94d049bb133111eb;
+            return x ^ ( x >> 31 );
+        };
+        const auto [ lo, hi ] = token1 < token0 ? std::pair{ token1, token0 } : std::pair{ token0, token1 };
+        uint64_t key = mix( lo.get_symbol().raw() );
+        key = mix( key ^ lo.get_contract().value );
+        key = mix( key ^ hi.get_symbol().raw() );
+        return mix( key ^ hi.get_contract().value );
+    }
+
+    /**
+     * Pair index (owned by the consuming contract, scope: self), `pair_key` of the tokens => pair id
+     *
+     * Filled by `index_pairs`, read by `get_pair_id` with one lookup per table.
+     */
+    struct [[eosio::table("pairindex")]] pair_index_row {
+        uint64_t        key;                // pair_key( token0, token1 )
+        uint64_t        pair_id;
+
+        uint64_t primary_key() const { return key; }
+    };
+    typedef eosio::multi_index< "pairindex"_n, pair_index_row > pair_index;
+
+    /**
+     * ## STATIC `index_pairs`
+     *
+     * Add pairs to the `pairindex` table of a contract, walking at most `limit` pairs from `lower_bound`
+     * (call again with the returned id to resume, or later with the last id to pick up new pairs)
+     *
+     * ### params
+     *
+     * - `{name} self` - contract owning the `pairindex` table
+     * - `{name} payer` - RAM payer
+     * - `{uint64_t} [lower_bound=0]` - first pair id to index
+     * - `{uint32_t} [limit=100]` - maximum pairs walked
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - next pair id to index
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t next = hamburger::index_pairs( get_self(), get_self() );
+     * // => 120 (pairs 1..119 indexed)
+     * ```
+     */
+    static uint64_t index_pairs( const name self, const name payer, const uint64_t lower_bound = 0, const uint32_t limit = 100 )
+    {
+        hamburger::pairs _pairs( code, code.value );
+        hamburger::pair_index _index( self, self.value );
+
+        uint64_t next = lower_bound;
+        uint32_t count = 0;
+        for ( auto itr = _pairs.lower_bound( lower_bound ); itr != _pairs.end() && count < limit; ++itr, ++count ) {
+            const uint64_t key = pair_key( itr->token0, itr->token1 );
+            if ( _index.find( key ) == _index.end() ) {     // a (64-bit) key collision keeps the first pair
+                _index.emplace( payer, [&]( auto& row ) {
+                    row.key = key;
+                    row.pair_id = itr->id;
+                });
+            }
+            next = itr->id + 1;
+        }
+        return next;
+    }
+
+    /**
+     * ## STATIC `get_pair_id`
+     *
+     * Find pair id of two tokens (in any order) through the `pairindex` table
+     *
+     * One index lookup plus one `pairs` lookup to verify the tokens, whatever the pair count.
+     *
+     * ### params
+     *
+     * - `{name} self` - contract owning the `pairindex` table (see `index_pairs`)
+     * - `{extended_symbol} token0` - first token
+     * - `{extended_symbol} token1` - second token
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - pair id (0 if pair does not exist or is not indexed)
+     *
+     * ### example
+     *
+     * ```c++
+     * const extended_symbol EOS = {{"EOS", 4}, "eosio.token"_n};
+     * const extended_symbol USDT = {{"USDT", 4}, "tethertether"_n};
+     *
+     * const uint64_t pair_id = hamburger::get_pair_id( get_self(), EOS, USDT );
+     * // => 1
+     * ```
+     */
+    static uint64_t get_pair_id( const name self, const extended_symbol token0, const extended_symbol token1 )
+    {
+        hamburger::pair_index _index( self, self.value );
+        const auto index = _index.find( pair_key( token0, token1 ) );
+        if ( index == _index.end() ) return 0;
+
+        hamburger::pairs _pairs( code, code.value );
+        const auto row = _pairs.find( index->pair_id );
+        if ( row == _pairs.end() ) return 0;
+        if ( ( row->token0 == token0 && row->token1 == token1 ) || ( row->token0 == token1 && row->token1 == token0 ) ) return row->id;
+        return 0;
+    }
+
+    /**
+     * ## CLASS `snapshot`
+     *
+     * Action scoped cache of Hamburger config & pair rows
+     *
+     * Rows are loaded lazily on first use and served from memory afterwards,
+     * call `invalidate` to drop them once a swap has been sent inline.
+     *
+     * ### example
+     *
+     * ```c++
+     * hamburger::snapshot snapshot;
+     *
+     * const uint8_t fee = snapshot.get_fee();
+     * const auto [reserve0, reserve1] = snapshot.get_reserves( 12, symbol{"EOS", 4} );
+     * // => same rows are re-used by any later lookup
+     *
+     * snapshot.invalidate();
+     * ```
+     */
+    class snapshot {
+    public:
+        /**
+         * Get config (shared `hamburger::get_config` cache)
+         */
+        const global_row& get_config()
+        {
+            HAMBURGER_PROFILE_CALL( snapshot_get_config );
+            return hamburger::get_config();
+        }
+
+        /**
+         * Get total fee (trade + protocol)
+         */
+        uint8_t get_fee()
+        {
+            return hamburger::get_fee( to_state( get_config() ) );
+        }
+
+        /**
+         * Check if swaps / trade mining are enabled
+         */
+        bool is_trading_enabled() { return hamburger::is_trading_enabled( to_state( get_config() ) ); }
+        bool is_mining_enabled() { return hamburger::is_mining_enabled( to_state( get_config() ) ); }
+
+        /**
+         * Get pair row (loaded once per pair id)
+         */
+        const pairs_row& get_pair( const uint64_t pair_id )
+        {
+            HAMBURGER_PROFILE_CALL( snapshot_get_pair );
+            auto itr = _rows.find( pair_id );
+            if ( itr == _rows.end() ) {
+                HAMBURGER_PROFILE_DB_READ( snapshot_get_pair );
+                itr = _rows.emplace( pair_id, _pairs.get( pair_id, "HamburgerLibrary: INVALID_PAIR_ID" ) ).first;
+            }
+            else HAMBURGER_PROFILE_CACHE_HIT( snapshot_get_pair );
+            return itr->second;
+        }
+
+        /**
+         * Get reserves for a pair
+         */
+        std::pair<asset, asset> get_reserves( const uint64_t pair_id, const symbol sort )
+        {
+            return sort_reserves( get_pair( pair_id ), sort );
+        }
+
+        /**
+         * Quote output of a pair
+         */
+        asset get_amount_out( const uint64_t pair_id, const asset in )
+        {
+            const auto [ reserve_in, reserve_out ] = get_reserves( pair_id, in.symbol );
+            const uint64_t amount_out = hamburger::get_amount_out( in.amount, reserve_in.amount, reserve_out.amount, get_fee() );
+            return { static_cast<int64_t>( amount_out ), reserve_out.symbol };
+        }
+
+        /**
+         * Quote required input of a pair
+         */
+        asset get_amount_in( const uint64_t pair_id, const asset out )
+        {
+            const auto [ reserve_out, reserve_in ] = get_reserves( pair_id, out.symbol );
+            const uint64_t amount_in = hamburger::get_amount_in( out.amount, reserve_in.amount, reserve_out.amount, get_fee() );
+            return { static_cast<int64_t>( amount_in ), reserve_in.symbol };
+        }
+
+        /**
+         * Quote a multi-hop path (see `quote_path`)
+         */
+        std::vector<asset> quote_path( asset in, const std::vector<uint64_t>& pair_ids )
+        {
+            const uint8_t fee = get_fee();
+
+            // reserves of visited pairs, moved by earlier hops when a pair appears twice
+            std::map<uint64_t, std::pair<asset, asset>> reserves;
+
+            std::vector<asset> res;
+            res.reserve( pair_ids.size() );
+            for ( const uint64_t pair_id : pair_ids ) {
+                auto itr = reserves.find( pair_id );
+                if ( itr == reserves.end() ) {
+                    const pairs_row& pair = get_pair( pair_id );
+                    itr = reserves.emplace( pair_id, std::pair<asset, asset>{ pair.reserve0, pair.reserve1 } ).first;
+                }
+                auto& [ reserve0, reserve1 ] = itr->second;
+                eosio::check( in.symbol == reserve0.symbol || in.symbol == reserve1.symbol, "HamburgerLibrary: INVALID_PATH" );
+
+                asset& reserve_in = in.symbol == reserve0.symbol ? reserve0 : reserve1;
+                asset& reserve_out = in.symbol == reserve0.symbol ? reserve1 : reserve0;
+                const asset out = { static_cast<int64_t>( hamburger::get_amount_out( in.amount, reserve_in.amount, reserve_out.amount, fee ) ), reserve_out.symbol };
+
+                reserve_in += in;
+                reserve_out -= out;
+                res.push_back( in = out );
+            }
+            return res;
+        }
+
+        /**
+         * Find pair id of two tokens through the `pairindex` table of `self` (each key & pair row is read once)
+         */
+        uint64_t get_pair_id( const name self, const extended_symbol token0, const extended_symbol token1 )
+        {
+            const uint64_t key = pair_key( token0, token1 );
+            auto itr = _ids.find( key );
+            if ( itr == _ids.end() ) {
+                hamburger::pair_index _index( self, self.value );
+                const auto index = _index.find( key );
+                itr = _ids.emplace( key, index == _index.end() ? 0 : index->pair_id ).first;
+            }
+            if ( !itr->second ) return 0;
+
+            auto row = _rows.find( itr->second );
+            if ( row == _rows.end() ) {
+                const auto pair = _pairs.find( itr->second );
+                if ( pair == _pairs.end() ) return 0;
+                row = _rows.emplace( pair->id, *pair ).first;
+            }
+            const pairs_row& pair = row->second;
+            if ( ( pair.token0 == token0 && pair.token1 == token1 ) || ( pair.token0 == token1 && pair.token1 == token0 ) ) return pair.id;
+            return 0;
+        }
+
+        /**
+         * Drop all cached rows (including the shared config cache)
+         */
+        void invalidate()
+        {
+            invalidate_config();
+            _rows.clear();
+            _ids.clear();
+        }
+
+        /**
+         * Drop cached row of a single pair
+         */
+        void invalidate( const uint64_t pair_id )
+        {
+            _rows.erase( pair_id );
+        }
+
+    private:
+        hamburger::pairs _pairs{ code, code.value };
+        std::map<uint64_t, pairs_row> _rows;
+        std::map<uint64_t, uint64_t> _ids;         // pair_key => indexed pair id (0 => not indexed)
+    };
+
+    /**
+     * ## STATIC `get_reserve_snapshots`
+     *
+     * Get compact reserve snapshots of many pairs (config & each pair row read once)
+     *
+     * ### params
+     *
+     * - `{vector<uint64_t>} pair_ids` - pair ids
+     *
+     * ### returns
+     *
+     * - `{vector<reserve_snapshot>}` - snapshots (same order as requested)
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto snapshots = hamburger::get_reserve_snapshots( { 12, 1 } );
+     * const std::vector<char> payload = hamburger::pack( snapshots );
+     * // payload.size() => 62
+     * ```
+     */
+    static std::vector<reserve_snapshot> get_reserve_snapshots( const std::vector<uint64_t>& pair_ids )
+    {
+        hamburger::snapshot snapshot;
+        const uint8_t fee = snapshot.get_fee();
+
+        std::vector<reserve_snapshot> res;
+        res.reserve( pair_ids.size() );
+        for ( const uint64_t pair_id : pair_ids ) res.push_back( to_snapshot( snapshot.get_pair( pair_id ), fee ) );
+        return res;
+    }
+
+    /**
+     * ## STATIC `get_rewards`
+     *
+     * Get rewards for trading
+     *
+     * Returns zero without reading any table for a non-EOS pair, and without reading `pools` when mining is
+     * disabled (`mine_status`).
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{asset} from` - tokens we are trading from
+     * - `{asset} to` - tokens we are trading to
+     *
+     * ### returns
+     *
+     * - {asset} = rewards in BOX
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t pair_id = 12;
+     * const asset from = asset{10000, {"EOS", 4}};
+     * const asset to = asset{12345, {"USDT", 4}};
+     *
+     * const auto rewards = hamburger::get_rewards( pair_id, from, to);
+     * // rewards => "0.123456 BOX"
+     * ```
+     */
+
+    static asset get_rewards( const uint64_t pair_id, asset in, asset out )
+    {
+        HAMBURGER_PROFILE_CALL( get_rewards );
+        asset res {0, HBG};
+        if(in.symbol != EOS) std::swap(in, out);
+        if(in.symbol != EOS)
+            return res;     //return 0 if non-EOS pair (no table read)
+        if(!is_mining_enabled()) return res;    //return 0 if mining is off (no pools lookup)
+
+
+        HAMBURGER_PROFILE_DB_READ( get_rewards );
+        hamburger::pools _pools( mine_code, mine_code.value );
+        auto poolit = _pools.find( pair_id );
+        if(poolit==_pools.end()) return res;
+
+        auto now = eosio::current_time_point().sec_since_epoch();
+        res.amount = get_rewards( to_state( *poolit ), now, in.amount );
+
+        return res;
+    }
+
+    /**
+     * ## STATIC `quote_path`
+     *
+     * Quote a multi-hop path, carrying each hop output into the next pair
+     *
+     * Every pair row is read once, a pair used twice is quoted against the reserves left by the earlier hop.
+     *
+     * ### params
+     *
+     * - `{asset} in` - tokens we are trading from
+     * - `{vector<uint64_t>} pair_ids` - pair ids in trading order
+     *
+     * ### returns
+     *
+     * - `{vector<asset>}` - output of each hop (last item is the path output)
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset in = asset{10000, symbol{"EOS", 4}};
+     *
+     * const auto outs = hamburger::quote_path( in, { 12, 1 } );
+     * // outs[0] => "2.7328 USDT"
+     * // outs[1] => "0.9917 EOS"
+     * ```
+     */
+    static std::vector<asset> quote_path( const asset in, const std::vector<uint64_t>& pair_ids )
+    {
+        hamburger::snapshot snapshot;
+        return snapshot.quote_path( in, pair_ids );
+    }
+
+    /**
+     * ## STATIC `get_arbitrage`
+     *
+     * Get profit-maximizing input of a round trip through two constant-product pairs
+     *
+     * Trades base tokens into pair `a`, sells the received tokens into pair `b` and returns the input
+     * maximizing `out - in` in closed form (integer square root, no iteration). Swap `a` & `b` to evaluate
+     * the opposite direction.
+     *
+     * ### params
+     *
+     * - `{pair<asset, asset>} reserves_a` - reserves of pair `a` sorted by base symbol (ex: `get_reserves( pair_id, base )`)
+     * - `{uint8_t} fee_a` - trade fee of pair `a` (pips 1/100 of 1%)
+     * - `{pair<asset, asset>} reserves_b` - reserves of pair `b` sorted by base symbol
+     * - `{uint8_t} fee_b` - trade fee of pair `b` (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{pair<asset, asset>}` - optimal input & expected profit in base tokens (both zero if not profitable)
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto reserves_a = hamburger::get_reserves( 12, symbol{"EOS", 4} );
+     * const auto reserves_b = defibox::get_reserves( 12, symbol{"EOS", 4} );
+     *
+     * const auto [ in, profit ] = hamburger::get_arbitrage( reserves_a, hamburger::get_fee(), reserves_b, defibox::get_fee() );
+     * // in => "6291.1930 EOS"
+     * // profit => "48.2251 EOS"
+     * ```
+     */
+    static std::pair<asset, asset> get_arbitrage( const std::pair<asset, asset>& reserves_a, const uint8_t fee_a, const std::pair<asset, asset>& reserves_b, const uint8_t fee_b )
+    {
+        eosio::check( reserves_a.first.symbol == reserves_b.first.symbol && reserves_a.second.symbol == reserves_b.second.symbol, "HamburgerLibrary: RESERVES_MISMATCH" );
+
+        const symbol base = reserves_a.first.symbol;
+        const auto [ in, profit ] = get_arbitrage( reserves_a.first.amount, reserves_a.second.amount, fee_a, reserves_b.second.amount, reserves_b.first.amount, fee_b );
+        return { asset{ static_cast<int64_t>( in ), base }, asset{ static_cast<int64_t>( profit ), base } };
+    }
+
+    /**
+     * ## STATIC `get_deposit`
+     *
+     * Get pending deposits of an owner
+     *
+     * ### params
+     *
+     * - `{name} owner` - owner account
+     *
+     * ### returns
+     *
+     * - `{optional<deposits_row>}` - deposits row (nullopt if none)
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto deposit = hamburger::get_deposit( "myaccount"_n );
+     * // deposit->quantity0 => "1.0000 EOS"
+     * // deposit->quantity1 => "2.7412 USDT"
+     * ```
+     */
+    static std::optional<deposits_row> get_deposit( const name owner )
+    {
+        hamburger::deposits _deposits( code, code.value );
+        const auto itr = _deposits.find( owner.value );
+        if ( itr == _deposits.end() ) return std::nullopt;
+        return *itr;
+    }
+
+    /**
+     * Liquidity position of an owner in a pair
+     */
+    struct position {
+        uint64_t                        pair_id;
+        uint64_t                        liquidity;          // liquidity owned
+        uint64_t                        total_liquidity;    // total liquidity of the pair
+        asset                           amount0;            // share of reserve0
+        asset                           amount1;            // share of reserve1
+        std::optional<deposits_row>     deposit;            // pending deposits
+    };
+
+    /**
+     * ## STATIC `get_position`
+     *
+     * Get the share of pair reserves owned by an amount of liquidity, with the owner pending deposits
+     *
+     * Reads the pair row and the deposits row once each; shares are rounded down like a withdrawal.
+     *
+     * ### params
+     *
+     * - `{name} owner` - owner account
+     * - `{uint64_t} pair_id` - pair id
+     * - `{uint64_t} liquidity` - liquidity owned (ex: LP token balance)
+     *
+     * ### returns
+     *
+     * - `{position}` - position
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto position = hamburger::get_position( "myaccount"_n, 12, 1000000 );
+     * // position.amount0 => "60.4010 EOS"
+     * // position.amount1 => "165.5617 USDT"
+     * ```
+     */
+    static position get_position( const name owner, const uint64_t pair_id, const uint64_t liquidity )
+    {
+        hamburger::pairs _pairs( code, code.value );
+        const pairs_row& pair = _pairs.get( pair_id, "HamburgerLibrary: INVALID_PAIR_ID" );
+
+        position res{ pair_id, liquidity, pair.total_liquidity, { 0, pair.reserve0.symbol }, { 0, pair.reserve1.symbol }, get_deposit( owner ) };
+        if ( liquidity == 0 ) return res;
+
+        res.amount0.amount = get_share( pair.reserve0.amount, liquidity, pair.total_liquidity );
+        res.amount1.amount = get_share( pair.reserve1.amount, liquidity, pair.total_liquidity );
+        return res;
+    }
+
+    /**
+     * ## STATIC `quote_add_liquidity`
+     *
+     * Quote a liquidity deposit with a single pair row read
+     *
+     * Like a router add, the desired amounts are reduced to the pair ratio (the side in excess is lowered,
+     * rounded down) before computing the liquidity minted.
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{asset} desired0` - desired amount of one token of the pair
+     * - `{asset} desired1` - desired amount of the other token
+     *
+     * ### returns
+     *
+     * - `{tuple<asset, asset, uint64_t>}` - amounts deposited (same order as desired) & liquidity minted
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto [ amount0, amount1, liquidity ] = hamburger::quote_add_liquidity( 12, asset{10000, symbol{"EOS", 4}}, asset{30000, symbol{"USDT", 4}} );
+     * // amount0 => "1.0000 EOS"
+     * // amount1 => "2.7410 USDT"
+     * // liquidity => 16555
+     * ```
+     */
+    static std::tuple<asset, asset, uint64_t> quote_add_liquidity( const uint64_t pair_id, const asset desired0, const asset desired1 )
+    {
+        hamburger::pairs _pairs( code, code.value );
+        const pairs_row& pair = _pairs.get( pair_id, "HamburgerLibrary: INVALID_PAIR_ID" );
+        const auto [ reserve0, reserve1 ] = sort_reserves( pair, desired0.symbol );
+        eosio::check( reserve1.symbol == desired1.symbol, "HamburgerLibrary: INVALID_SYMBOL" );
+
+        asset amount0 = desired0, amount1 = desired1;
+        if ( pair.total_liquidity > 0 ) {
+            const uint64_t optimal1 = get_quote( desired0.amount, reserve0.amount, reserve1.amount );
+            if ( optimal1 <= static_cast<uint64_t>( desired1.amount ) ) amount1.amount = optimal1;
+            else amount0.amount = get_quote( desired1.amount, reserve1.amount, reserve0.amount );
+        }
+        return { amount0, amount1, get_liquidity( amount0.amount, amount1.amount, reserve0.amount, reserve1.amount, pair.total_liquidity ) };
+    }
+
+    /**
+     * ## STATIC `quote_remove_liquidity`
+     *
+     * Quote the assets returned when withdrawing liquidity, with a single pair row read (rounded down)
+     *
+     * ### params
+     *
+     * - `{uint64_t} pair_id` - pair id
+     * - `{uint64_t} liquidity` - liquidity withdrawn
+     *
+     * ### returns
+     *
+     * - `{pair<asset, asset>}` - amounts of reserve0 & reserve1 returned
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto [ amount0, amount1 ] = hamburger::quote_remove_liquidity( 12, 16555 );
+     * // amount0 => "0.9999 EOS"
+     * // amount1 => "2.7408 USDT"
+     * ```
+     */
+    static std::pair<asset, asset> quote_remove_liquidity( const uint64_t pair_id, const uint64_t liquidity )
+    {
+        hamburger::pairs _pairs( code, code.value );
+        const pairs_row& pair = _pairs.get( pair_id, "HamburgerLibrary: INVALID_PAIR_ID" );
+        eosio::check( liquidity > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY_BURNED" );
+
+        return {
+            asset{ static_cast<int64_t>( get_share( pair.reserve0.amount, liquidity, pair.total_liquidity ) ), pair.reserve0.symbol },
+            asset{ static_cast<int64_t>( get_share( pair.reserve1.amount, liquidity, pair.total_liquidity ) ), pair.reserve1.symbol }
+        };
+    }
+
+    /**
+     * Mining rewards of a pool
+     */
+    struct pool_rewards {
+        uint64_t        pair_id;
+        asset           rate;               // HBG emitted per second
+        asset           rewards;            // HBG rewarded for the quoted EOS amount now
+    };
+
+    /**
+     * ## STATIC `get_pools_rewards`
+     *
+     * Get emission rate & projected rewards of every active mining pool, walking the `pools` table once
+     * (empty without reading `pools` when mining is disabled)
+     *
+     * ### params
+     *
+     * - `{asset} in` - EOS amount traded (default 1.0000 EOS)
+     *
+     * ### returns
+     *
+     * - `{vector<pool_rewards>}` - active pools in pair id order
+     *
+     * ### example
+     *
+     * ```c++
+     * const auto pools = hamburger::get_pools_rewards();
+     * // pools[0].pair_id => 12
+     * // pools[0].rate => "0.007500 HBG"
+     * // pools[0].rewards => "0.100000 HBG"
+     * ```
+     */
+    static std::vector<pool_rewards> get_pools_rewards( const asset in = asset{ 10000, EOS } )
+    {
+        eosio::check( in.symbol == EOS, "HamburgerLibrary: INVALID_SYMBOL" );
+        if ( !is_mining_enabled() ) return {};
+
+        hamburger::pools _pools( mine_code, mine_code.value );
+        const uint32_t now = eosio::current_time_point().sec_since_epoch();
+
+        std::vector<pool_rewards> res;
+        for ( const pools_row& row : _pools ) {
+            const pool_state pool = to_state( row );
+            if ( !is_active( pool, now ) ) continue;
+            res.push_back( { pool.pair_id, asset{ get_emission_rate( pool.weight ), HBG }, asset{ get_rewards( pool, now, in.amount ), HBG } } );
+        }
+        return res;
+    }
+
+    /**
+     * Route ranked by net output (output + HBG rewards valued in the output token)
+     */
+    struct route_quote {
+        uint32_t        index;              // position in the candidate routes
+        asset           out;
+        asset           rewards;            // HBG mined by the EOS side of every hop
+        asset           net;
+    };
+
+    /**
+     * ## STATIC `rank_routes`
+     *
+     * Rank candidate routes by output plus HBG mining rewards in a single pass: config, every `pairs_row`
+     * and every `pools_row` are read once across all routes (a pair used twice in a route is quoted
+     * against the reserves left by the earlier hop, like `quote_path`)
+     *
+     * ### params
+     *
+     * - `{asset} in` - tokens we are trading from
+     * - `{vector<vector<uint64_t>>} routes` - candidate routes (pair ids in trading order)
+     * - `{asset} hbg_price` - price of 1 HBG in the output token of the routes (ex: HBG/EOS price), must be non-negative
+     *
+     * ### returns
+     *
+     * - `{vector<route_quote>}` - routes by descending net output
+     *
+     * ### example
+     *
+     * ```c++
+     * const asset in = asset{27328, symbol{"USDT", 4}};
+     *
+     * const auto ranked = hamburger::rank_routes( in, { { 12 }, { 7, 1 } }, asset{100, symbol{"EOS", 4}} );
+     * // ranked[0].index => 0
+     * // ranked[0].out => "0.9940 EOS"
+     * // ranked[0].rewards => "0.099000 HBG"
+     * // ranked[0].net => "0.9949 EOS"
+     * ```
+     */
+    static std::vector<route_quote> rank_routes( const asset in, const std::vector<std::vector<uint64_t>>& routes, const asset hbg_price )
+    {
+        eosio::check( hbg_price.amount >= 0 && hbg_price.is_valid(), "HamburgerLibrary: INVALID_PRICE" );
+
+        hamburger::snapshot snapshot;
+        const bool mining = snapshot.is_mining_enabled();
+        const uint32_t now = eosio::current_time_point().sec_since_epoch();
 
-        if(now > poolit->end_time) return res;    //if mining ended
+        hamburger::pools _pools( mine_code, mine_code.value );
+        std::map<uint64_t, std::optional<pool_state>> pools;
+        const auto get_pool = [&]( const uint64_t pair_id ) -> const std::optional<pool_state>& {
+            auto itr = pools.find( pair_id );
+            if ( itr == pools.end() ) {
+                const auto row = _pools.find( pair_id );
+                itr = pools.emplace( pair_id, row == _pools.end() ? std::nullopt : std::optional{ to_state( *row ) } ).first;
+            }
+            return itr->second;
+        };
 
-        float newsecs = now - poolit->last_issue_time;  //second since last update
-        auto total = poolit->balance.amount + poolit->weight * 0.005 * newsecs * 1000000;
+        uint64_t unit = 1;
+        for ( uint8_t i = 0; i < HBG.precision(); ++i ) unit *= 10;
 
-        res.amount = total - total * pow(0.9999, in.amount / 10000);
+        std::vector<route_quote> res;
+        res.reserve( routes.size() );
+        for ( uint32_t i = 0; i < routes.size(); ++i ) {
+            const std::vector<asset> outs = snapshot.quote_path( in, routes[i] );
+            eosio::check( !outs.empty() && outs.back().symbol == hbg_price.symbol, "HamburgerLibrary: INVALID_SYMBOL" );
 
+            asset rewards{ 0, HBG };
+            for ( size_t hop = 0; mining && hop < outs.size(); ++hop ) {
+                const asset& hop_in = hop ? outs[hop - 1] : in;
+                if ( hop_in.symbol != EOS && outs[hop].symbol != EOS ) continue;
+                const auto& pool = get_pool( routes[i][hop] );
+                if ( pool ) rewards.amount += get_rewards( *pool, now, hop_in.symbol == EOS ? hop_in.amount : outs[hop].amount );
+            }
+            const uint128_t value = static_cast<uint128_t>( rewards.amount ) * hbg_price.amount / unit;
+            eosio::check( value <= asset::max_amount, "HamburgerLibrary: VALUE_OVERFLOW" );
+            res.push_back( { i, outs.back(), rewards, outs.back() + asset{ static_cast<int64_t>( value ), hbg_price.symbol } } );
+        }
+        std::stable_sort( res.begin(), res.end(), []( const route_quote& a, const route_quote& b ) { return a.net > b.net; } );
         return res;
     }
-}
\ No newline at end of file
+}
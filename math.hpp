@@ -0,0 +1,828 @@
+#pragma once
+
+/**
+ * Pure Hamburger pricing math
+ *
+ * No eosio.cdt dependency: included by `hamburger.hpp` on-chain and builds natively (GCC/Clang, C++17)
+ * for off-chain bots, so both sides share the exact same integer code paths.
+ * Define `HAMBURGER_NATIVE` to force the native `check` when eosio.cdt headers are on the include path.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined( HAMBURGER_NATIVE ) || !__has_include( <eosio/check.hpp> )
+#include <stdexcept>
+#else
+#include <eosio/check.hpp>
+#endif
+
+namespace hamburger {
+
+    using uint128_t = unsigned __int128;
+
+#if defined( HAMBURGER_NATIVE ) || !__has_include( <eosio/check.hpp> )
+    static void check( const bool condition, const char* message )
+    {
+        if ( !condition ) throw std::runtime_error( message );
+    }
+#else
+    using eosio::check;
+#endif
+
+    /**
+     * Maximum amount of an asset
+     */
+    static constexpr int64_t max_amount = ( 1LL << 62 ) - 1;
+
+    /**
+     * Hamburger pair (plain mirror of `pairs_row`)
+     */
+    struct pair_state {
+        uint64_t            id = 0;
+        uint64_t            symbol0 = 0;            // raw symbol of reserve0
+        uint64_t            symbol1 = 0;            // raw symbol of reserve1
+        int64_t             reserve0 = 0;
+        int64_t             reserve1 = 0;
+        uint64_t            total_liquidity = 0;
+        uint32_t            last_update_time = 0;
+        uint64_t            contract0 = 0;          // token0 contract (name value)
+        uint64_t            contract1 = 0;          // token1 contract (name value)
+    };
+
+    /**
+     * Hamburger config (plain mirror of `global_row`)
+     */
+    struct config_state {
+        uint8_t             contract_status = 1;
+        uint8_t             mine_status = 1;
+        uint8_t             trade_fee = 20;
+        uint8_t             protocol_fee = 10;
+    };
+
+    /**
+     * Deposit (plain mirror of `deposits_row`)
+     */
+    struct deposit_state {
+        uint64_t            owner = 0;              // name value
+        uint64_t            symbol0 = 0;            // raw symbol of quantity0
+        int64_t             quantity0 = 0;
+        uint64_t            symbol1 = 0;            // raw symbol of quantity1
+        int64_t             quantity1 = 0;
+    };
+
+    /**
+     * HBG mine pool (plain mirror of `pools_row`)
+     */
+    struct pool_state {
+        uint64_t            pair_id = 0;
+        double              weight = 0;
+        int64_t             balance = 0;
+        uint32_t            last_issue_time = 0;
+        uint32_t            start_time = 0;
+        uint32_t            end_time = 0;
+    };
+
+    /**
+     * ## STATIC `get_fee`
+     *
+     * Get total fee of a config
+     *
+     * ### params
+     *
+     * - `{config_state} config` - config
+     *
+     * ### returns
+     *
+     * - `{uint8_t}` - total fee (trade + protocol)
+     */
+    static uint8_t get_fee( const config_state& config )
+    {
+        return config.trade_fee + config.protocol_fee;
+    }
+
+    /**
+     * ## STATIC `is_trading_enabled`
+     *
+     * Check if swaps are enabled by a config (`contract_status` 1)
+     *
+     * ### params
+     *
+     * - `{config_state} config` - config
+     *
+     * ### returns
+     *
+     * - `{bool}` - true if enabled
+     */
+    static bool is_trading_enabled( const config_state& config )
+    {
+        return config.contract_status == 1;
+    }
+
+    /**
+     * ## STATIC `is_mining_enabled`
+     *
+     * Check if trade mining is enabled by a config (`mine_status` 1)
+     *
+     * ### params
+     *
+     * - `{config_state} config` - config
+     *
+     * ### returns
+     *
+     * - `{bool}` - true if enabled
+     */
+    static bool is_mining_enabled( const config_state& config )
+    {
+        return config.mine_status == 1;
+    }
+
+    /**
+     * ## STATIC `sort_reserves`
+     *
+     * Sort reserves of a pair
+     *
+     * ### params
+     *
+     * - `{pair_state} pair` - pair
+     * - `{uint64_t} sort` - raw sort symbol (reserve0 will be first item in pair)
+     *
+     * ### returns
+     *
+     * - `{pair<int64_t, int64_t>}` - pair of reserve amounts
+     */
+    static std::pair<int64_t, int64_t> sort_reserves( const pair_state& pair, const uint64_t sort )
+    {
+        check( pair.symbol0 == sort || pair.symbol1 == sort, "sort symbol does not match" );
+
+        return sort == pair.symbol0 ?
+            std::pair<int64_t, int64_t>{ pair.reserve0, pair.reserve1 } :
+            std::pair<int64_t, int64_t>{ pair.reserve1, pair.reserve0 };
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Given an input amount of an asset and pair reserves, returns the maximum output amount of the other asset
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_in` - amount input
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint64_t} reserve_out` - reserve output
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount out
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_out = hamburger::get_amount_out( 10000, 45851931234, 125682033533, 30 );
+     * // => 27328
+     * ```
+     */
+    static uint64_t get_amount_out( const uint64_t amount_in, const uint64_t reserve_in, const uint64_t reserve_out, const uint8_t fee )
+    {
+        check( amount_in > 0, "HamburgerLibrary: INSUFFICIENT_INPUT_AMOUNT" );
+        check( reserve_in > 0 && reserve_out > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+
+        const uint128_t amount_in_with_fee = static_cast<uint128_t>( amount_in ) * ( 10000 - fee );
+        const uint128_t numerator = amount_in_with_fee * reserve_out;
+        const uint128_t denominator = static_cast<uint128_t>( reserve_in ) * 10000 + amount_in_with_fee;
+        return numerator / denominator;
+    }
+
+    /**
+     * ## STATIC `get_amount_in`
+     *
+     * Given an output amount of an asset and pair reserves, returns a required input amount of the other asset
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_out` - amount output
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint64_t} reserve_out` - reserve output
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount in
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_in = hamburger::get_amount_in( 27328, 45851931234, 125682033533, 30 );
+     * // => 10000
+     * ```
+     */
+    static uint64_t get_amount_in( const uint64_t amount_out, const uint64_t reserve_in, const uint64_t reserve_out, const uint8_t fee )
+    {
+        check( amount_out > 0, "HamburgerLibrary: INSUFFICIENT_OUTPUT_AMOUNT" );
+        check( reserve_in > 0 && reserve_out > amount_out, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+
+        const uint128_t numerator = static_cast<uint128_t>( reserve_in ) * amount_out * 10000;
+        const uint128_t denominator = static_cast<uint128_t>( reserve_out - amount_out ) * ( 10000 - fee );
+        return numerator / denominator + 1;
+    }
+
+    /**
+     * ## STATIC `get_price_impact`
+     *
+     * Given an input amount and pair reserves, returns the price impact of the trade excluding the fee
+     *
+     * The execution price (after fee) over the mid price is `reserve_in / (reserve_in + amount_in_with_fee)`.
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_in` - amount input
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - price impact in basis points (rounded up)
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t impact = hamburger::get_price_impact( 500000000, 45851931234, 30 );
+     * // => 108
+     * ```
+     */
+    static uint64_t get_price_impact( const uint64_t amount_in, const uint64_t reserve_in, const uint8_t fee )
+    {
+        check( amount_in > 0, "HamburgerLibrary: INSUFFICIENT_INPUT_AMOUNT" );
+        check( reserve_in > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+
+        const uint128_t amount_in_with_fee = static_cast<uint128_t>( amount_in ) * ( 10000 - fee );
+        const uint128_t denominator = static_cast<uint128_t>( reserve_in ) * 10000 + amount_in_with_fee;
+        return ( amount_in_with_fee * 10000 + denominator - 1 ) / denominator;
+    }
+
+    /**
+     * ## STATIC `get_share`
+     *
+     * Given an amount of liquidity, returns its share of a reserve (rounded down like a withdrawal)
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve` - reserve
+     * - `{uint64_t} liquidity` - liquidity owned
+     * - `{uint64_t} total_liquidity` - total liquidity of the pair
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount of the reserve
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount = hamburger::get_share( 45851931234, 1000000, 75912498501 );
+     * // => 604010
+     * ```
+     */
+    static uint64_t get_share( const uint64_t reserve, const uint64_t liquidity, const uint64_t total_liquidity )
+    {
+        check( total_liquidity > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+        check( liquidity <= total_liquidity, "HamburgerLibrary: INVALID_LIQUIDITY" );
+
+        return static_cast<uint128_t>( reserve ) * liquidity / total_liquidity;
+    }
+
+    /**
+     * 256-bit unsigned integer used by the closed-form solvers
+     */
+    struct uint256 {
+        uint128_t hi = 0;
+        uint128_t lo = 0;
+
+        friend bool operator<( const uint256& a, const uint256& b ) { return a.hi < b.hi || ( a.hi == b.hi && a.lo < b.lo ); }
+        friend bool operator<=( const uint256& a, const uint256& b ) { return !( b < a ); }
+    };
+
+    /**
+     * Full 128 x 128 => 256-bit product
+     */
+    static uint256 mul256( const uint128_t a, const uint128_t b )
+    {
+        const uint128_t a0 = static_cast<uint64_t>( a ), a1 = a >> 64;
+        const uint128_t b0 = static_cast<uint64_t>( b ), b1 = b >> 64;
+        const uint128_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+        const uint128_t mid = ( p00 >> 64 ) + static_cast<uint64_t>( p01 ) + static_cast<uint64_t>( p10 );
+
+        return { p11 + ( p01 >> 64 ) + ( p10 >> 64 ) + ( mid >> 64 ), ( mid << 64 ) | static_cast<uint64_t>( p00 ) };
+    }
+
+    /**
+     * 256 x 64 => 256-bit product (fails on overflow)
+     */
+    static uint256 mul256( const uint256 a, const uint64_t b )
+    {
+        const uint128_t t0 = static_cast<uint128_t>( static_cast<uint64_t>( a.lo ) ) * b;
+        const uint128_t t1 = ( a.lo >> 64 ) * b + ( t0 >> 64 );
+        const uint128_t t2 = static_cast<uint128_t>( static_cast<uint64_t>( a.hi ) ) * b + ( t1 >> 64 );
+        const uint128_t t3 = ( a.hi >> 64 ) * b + ( t2 >> 64 );
+        check( ( t3 >> 64 ) == 0, "HamburgerLibrary: OVERFLOW" );
+
+        return { ( t3 << 64 ) | static_cast<uint64_t>( t2 ), ( t1 << 64 ) | static_cast<uint64_t>( t0 ) };
+    }
+
+    /**
+     * 256 + 256 => 256-bit sum (fails on overflow)
+     */
+    static uint256 add256( const uint256 a, const uint256 b )
+    {
+        const uint128_t lo = a.lo + b.lo;
+        const uint128_t hi = a.hi + b.hi + ( lo < a.lo );
+        check( hi >= a.hi, "HamburgerLibrary: OVERFLOW" );
+
+        return { hi, lo };
+    }
+
+    /**
+     * 256 / 64 => 256-bit quotient (floor)
+     */
+    static uint256 div256( const uint256 a, const uint64_t b )
+    {
+        check( b > 0, "HamburgerLibrary: DIVISION_BY_ZERO" );
+
+        const uint64_t limbs[4] = { static_cast<uint64_t>( a.hi >> 64 ), static_cast<uint64_t>( a.hi ), static_cast<uint64_t>( a.lo >> 64 ), static_cast<uint64_t>( a.lo ) };
+        uint64_t q[4];
+        uint128_t rem = 0;
+        for ( int i = 0; i < 4; ++i ) {
+            const uint128_t cur = rem << 64 | limbs[i];
+            q[i] = static_cast<uint64_t>( cur / b );
+            rem = cur % b;
+        }
+        return { static_cast<uint128_t>( q[0] ) << 64 | q[1], static_cast<uint128_t>( q[2] ) << 64 | q[3] };
+    }
+
+    /**
+     * Integer square root (floor) of a 256-bit value
+     */
+    static uint128_t sqrt( const uint256 x )
+    {
+        uint128_t res = 0;
+        for ( int bit = 127; bit >= 0; --bit ) {
+            const uint128_t next = res | ( static_cast<uint128_t>( 1 ) << bit );
+            if ( mul256( next, next ) <= x ) res = next;
+        }
+        return res;
+    }
+
+    /**
+     * ## STATIC `get_liquidity`
+     *
+     * Given deposit amounts and pair reserves, returns the liquidity minted (rounded down)
+     *
+     * First deposit mints `sqrt(amount0 * amount1)`, later deposits mint the smaller of both proportional
+     * shares `amount * total_liquidity / reserve`.
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount0` - amount of reserve0 deposited
+     * - `{uint64_t} amount1` - amount of reserve1 deposited
+     * - `{uint64_t} reserve0` - reserve0
+     * - `{uint64_t} reserve1` - reserve1
+     * - `{uint64_t} total_liquidity` - total liquidity of the pair
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - liquidity minted
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t liquidity = hamburger::get_liquidity( 10000, 27410, 45851931234, 125682033533, 75912498501 );
+     * // => 16555
+     * ```
+     */
+    static uint64_t get_liquidity( const uint64_t amount0, const uint64_t amount1, const uint64_t reserve0, const uint64_t reserve1, const uint64_t total_liquidity )
+    {
+        check( amount0 > 0 && amount1 > 0, "HamburgerLibrary: INSUFFICIENT_AMOUNT" );
+
+        if ( total_liquidity == 0 ) return static_cast<uint64_t>( sqrt( uint256{ 0, static_cast<uint128_t>( amount0 ) * amount1 } ) );
+
+        check( reserve0 > 0 && reserve1 > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+        const uint128_t liquidity0 = static_cast<uint128_t>( amount0 ) * total_liquidity / reserve0;
+        const uint128_t liquidity1 = static_cast<uint128_t>( amount1 ) * total_liquidity / reserve1;
+        const uint128_t res = std::min( liquidity0, liquidity1 );
+        check( res <= UINT64_MAX, "HamburgerLibrary: OVERFLOW" );
+        return static_cast<uint64_t>( res );
+    }
+
+    /**
+     * ## STATIC `get_quote`
+     *
+     * Given an amount of an asset and pair reserves, returns the equivalent amount of the other asset (no fee)
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount_a` - amount of asset a
+     * - `{uint64_t} reserve_a` - reserve of asset a
+     * - `{uint64_t} reserve_b` - reserve of asset b
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount of asset b
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_b = hamburger::get_quote( 10000, 45851931234, 125682033533 );
+     * // => 27410
+     * ```
+     */
+    static uint64_t get_quote( const uint64_t amount_a, const uint64_t reserve_a, const uint64_t reserve_b )
+    {
+        check( amount_a > 0, "HamburgerLibrary: INSUFFICIENT_AMOUNT" );
+        check( reserve_a > 0 && reserve_b > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+
+        const uint128_t res = static_cast<uint128_t>( amount_a ) * reserve_b / reserve_a;
+        check( res <= UINT64_MAX, "HamburgerLibrary: OVERFLOW" );
+        return static_cast<uint64_t>( res );
+    }
+
+    /**
+     * Q63 powers `0.9999 ^ (2 ^ i)` used by `get_rewards` (higher powers round to zero)
+     */
+    static constexpr std::array<uint64_t, 19> pow9999_table = []() {
+        std::array<uint64_t, 19> table{};
+        table[0] = ( ( static_cast<uint128_t>( 1 ) << 63 ) * 9999 + 5000 ) / 10000;
+        for ( size_t i = 1; i < table.size(); ++i ) {
+            table[i] = ( static_cast<uint128_t>( table[i - 1] ) * table[i - 1] + ( 1ULL << 62 ) ) >> 63;
+        }
+        return table;
+    }();
+
+    /**
+     * `0.9999 ^ exponent` in Q63 fixed-point (exponentiation by squaring)
+     */
+    static uint64_t pow9999( const uint64_t exponent )
+    {
+        if ( exponent >> pow9999_table.size() ) return 0;
+
+        uint64_t res = 1ULL << 63;
+        for ( size_t i = 0; i < pow9999_table.size(); ++i ) {
+            if ( exponent >> i & 1 ) res = ( static_cast<uint128_t>( res ) * pow9999_table[i] + ( 1ULL << 62 ) ) >> 63;
+        }
+        return res;
+    }
+
+    /**
+     * Positive IEEE-754 double as `mantissa * 2 ^ exponent`, decoded from its bits (no floating point instructions)
+     */
+    static std::pair<uint64_t, int> decode_double( const double value )
+    {
+        uint64_t bits;
+        std::memcpy( &bits, &value, sizeof( bits ) );
+
+        const int exponent = ( bits >> 52 ) & 0x7ff;
+        if ( bits >> 63 || exponent == 0 ) return { 0, 0 };     // negative, zero or subnormal
+        check( exponent < 1023 + 32, "HamburgerLibrary: INVALID_WEIGHT" );
+        return { ( bits & ( ( 1ULL << 52 ) - 1 ) ) | ( 1ULL << 52 ), exponent - 1075 };
+    }
+
+    /**
+     * Positive IEEE-754 double to Q32 fixed-point
+     */
+    static uint128_t to_q32( const double value )
+    {
+        const auto [ mantissa, exponent ] = decode_double( value );
+        const int shift = exponent + 32;
+        if ( shift >= 0 ) return static_cast<uint128_t>( mantissa ) << shift;
+        return shift > -64 ? mantissa >> -shift : 0;
+    }
+
+    /**
+     * ## STATIC `get_rewards`
+     *
+     * Get rewards for trading from raw pool values
+     *
+     * Fixed-point port of the mining formula `total - total * 0.9999 ^ (amount_in / 10000)`, matching the
+     * floating point result within 1 unit (0.000001 HBG) for any `newsecs`: the weight is carried exactly
+     * (not truncated to a fixed number of fractional bits). `amount_in / 10000` keeps the integer truncation
+     * of the original (rewards are counted per whole EOS).
+     *
+     * ### params
+     *
+     * - `{int64_t} balance` - pool balance amount
+     * - `{double} weight` - pool weight
+     * - `{uint32_t} newsecs` - seconds since last issue
+     * - `{int64_t} amount_in` - EOS amount traded
+     *
+     * ### returns
+     *
+     * - `{int64_t}` - rewards amount in HBG
+     *
+     * ### example
+     *
+     * ```c++
+     * const int64_t rewards = hamburger::get_rewards( 1000000000, 1.5, 60, 100000 );
+     * // => 999999
+     * ```
+     */
+    static int64_t get_rewards( const int64_t balance, const double weight, const uint32_t newsecs, const int64_t amount_in )
+    {
+        if ( balance < 0 || amount_in <= 0 ) return 0;
+
+        // pool balance + 0.005 HBG emitted per weight per second (Q64), the weight is kept exact:
+        // 53-bit mantissa * 5000 * newsecs < 2^98 before scaling by its exponent
+        const auto [ mantissa, exponent ] = decode_double( weight );
+        const uint128_t emitted = static_cast<uint128_t>( mantissa ) * 5000 * newsecs;
+        const int shift = exponent + 64;
+        check( shift <= 0 || ( shift < 127 && emitted >> ( 127 - shift ) == 0 ), "HamburgerLibrary: INVALID_WEIGHT" );
+        const uint128_t total = ( static_cast<uint128_t>( balance ) << 64 ) + ( shift >= 0 ? emitted << shift : shift > -128 ? emitted >> -shift : 0 );
+        const uint256 rewards = mul256( total, ( 1ULL << 63 ) - pow9999( amount_in / 10000 ) );
+
+        return static_cast<int64_t>( ( rewards.hi << 1 ) | ( rewards.lo >> 127 ) );
+    }
+
+    /**
+     * ## STATIC `get_amount_out`
+     *
+     * Quote output of a pair
+     *
+     * ### params
+     *
+     * - `{pair_state} pair` - pair
+     * - `{uint64_t} sort` - raw symbol of tokens we are trading from
+     * - `{uint64_t} amount_in` - amount input
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount out
+     */
+    static uint64_t get_amount_out( const pair_state& pair, const uint64_t sort, const uint64_t amount_in, const uint8_t fee )
+    {
+        const auto [ reserve_in, reserve_out ] = sort_reserves( pair, sort );
+        return get_amount_out( amount_in, reserve_in, reserve_out, fee );
+    }
+
+    /**
+     * ## STATIC `get_rewards`
+     *
+     * Get rewards of a pool for an EOS amount traded
+     *
+     * ### params
+     *
+     * - `{pool_state} pool` - pool
+     * - `{uint32_t} now` - current time (seconds since epoch)
+     * - `{int64_t} amount_in` - EOS amount traded
+     *
+     * ### returns
+     *
+     * - `{int64_t}` - rewards amount in HBG
+     */
+    static int64_t get_rewards( const pool_state& pool, const uint32_t now, const int64_t amount_in )
+    {
+        if ( now > pool.end_time ) return 0;    //if mining ended
+
+        const uint32_t newsecs = now > pool.last_issue_time ? now - pool.last_issue_time : 0;  //second since last update
+        return get_rewards( pool.balance, pool.weight, newsecs, amount_in );
+    }
+
+    /**
+     * ## STATIC `is_active`
+     *
+     * Check if a pool is mining at a given time (`start_time` to `end_time` inclusive)
+     *
+     * ### params
+     *
+     * - `{pool_state} pool` - pool
+     * - `{uint32_t} now` - current time (seconds since epoch)
+     *
+     * ### returns
+     *
+     * - `{bool}` - true if active
+     */
+    static bool is_active( const pool_state& pool, const uint32_t now )
+    {
+        return pool.start_time <= now && now <= pool.end_time;
+    }
+
+    /**
+     * ## STATIC `get_emission_rate`
+     *
+     * Get HBG emitted into a pool per second (0.005 HBG per weight per second, rounded down)
+     *
+     * ### params
+     *
+     * - `{double} weight` - pool weight
+     *
+     * ### returns
+     *
+     * - `{int64_t}` - HBG amount per second
+     *
+     * ### example
+     *
+     * ```c++
+     * const int64_t rate = hamburger::get_emission_rate( 1.5 );
+     * // => 7500
+     * ```
+     */
+    static int64_t get_emission_rate( const double weight )
+    {
+        return static_cast<int64_t>( to_q32( weight ) * 5000 >> 32 );
+    }
+
+    /**
+     * ## STATIC `get_arbitrage`
+     *
+     * Get profit-maximizing input of a round trip through two constant-product pairs (raw amounts)
+     *
+     * ### params
+     *
+     * - `{uint64_t} r1_in` - base reserve of pair `a`
+     * - `{uint64_t} r1_out` - quote reserve of pair `a`
+     * - `{uint8_t} fee_a` - trade fee of pair `a` (pips 1/100 of 1%)
+     * - `{uint64_t} r2_in` - quote reserve of pair `b`
+     * - `{uint64_t} r2_out` - base reserve of pair `b`
+     * - `{uint8_t} fee_b` - trade fee of pair `b` (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{pair<uint64_t, uint64_t>}` - optimal base input & expected profit (both zero if not profitable)
+     */
+    static std::pair<uint64_t, uint64_t> get_arbitrage( const uint64_t r1_in, const uint64_t r1_out, const uint8_t fee_a, const uint64_t r2_in, const uint64_t r2_out, const uint8_t fee_b )
+    {
+        if ( !r1_in || !r1_out || !r2_in || !r2_out ) return { 0, 0 };
+
+        // profit(x) = K x / (D + M x) - x  is maximal at  x = N (sqrt(n1 n2 P) - N D) / (n1 (N r2_in + n2 r1_out))
+        const uint64_t N = 10000, n1 = N - fee_a, n2 = N - fee_b;
+        const uint256 P = mul256( static_cast<uint128_t>( r1_in ) * r1_out, static_cast<uint128_t>( r2_in ) * r2_out );
+        const uint128_t root = sqrt( mul256( P, n1 * n2 ) );
+        const uint256 ND = mul256( static_cast<uint128_t>( r1_in ) * r2_in, N );
+        if ( !( ND < uint256{ 0, root } ) ) return { 0, 0 };
+
+        const uint128_t diff = root - ND.lo;
+        const uint128_t denominator = n1 * ( static_cast<uint128_t>( r2_in ) * N + static_cast<uint128_t>( r1_out ) * n2 );
+        const uint128_t x = diff / denominator * N + diff % denominator * N / denominator;
+        if ( x == 0 || x > max_amount ) return { 0, 0 };
+
+        const uint64_t mid = get_amount_out( x, r1_in, r1_out, fee_a );
+        if ( mid == 0 ) return { 0, 0 };
+        const uint64_t out = get_amount_out( mid, r2_in, r2_out, fee_b );
+        if ( out <= x ) return { 0, 0 };
+
+        return { static_cast<uint64_t>( x ), out - static_cast<uint64_t>( x ) };
+    }
+
+    /**
+     * ## STATIC `get_amount_to_price`
+     *
+     * Given pair reserves, returns the maximum input moving the pair price down to a target (closed form)
+     *
+     * Selling `x` leaves a spot price `reserve_out' / reserve_in' = reserve_in * reserve_out / ((reserve_in + g x)(reserve_in + x))`
+     * with `g = (10000 - fee) / 10000`; solving for the target price `P` gives
+     * `x = (sqrt((N - n)^2 reserve_in^2 + 4 n N reserve_in reserve_out / P) - (N + n) reserve_in) / 2n`.
+     *
+     * ### params
+     *
+     * - `{uint64_t} reserve_in` - reserve input
+     * - `{uint64_t} reserve_out` - reserve output
+     * - `{uint64_t} price_num` - target price numerator (output amount)
+     * - `{uint64_t} price_den` - target price denominator (input amount)
+     * - `{uint8_t} fee` - trade fee (pips 1/100 of 1%)
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - amount in (0 if the price is already at or below target)
+     *
+     * ### example
+     *
+     * ```c++
+     * // sell EOS until 2.7000 USDT per 1.0000 EOS
+     * const uint64_t amount_in = hamburger::get_amount_to_price( 45851931234, 125682033533, 27000, 10000, 30 );
+     * // => 347692266
+     * ```
+     */
+    static uint64_t get_amount_to_price( const uint64_t reserve_in, const uint64_t reserve_out, const uint64_t price_num, const uint64_t price_den, const uint8_t fee )
+    {
+        check( reserve_in > 0 && reserve_out > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+        check( price_num > 0 && price_den > 0, "HamburgerLibrary: INVALID_PRICE" );
+
+        // current price reserve_out / reserve_in at or below target
+        if ( static_cast<uint128_t>( reserve_out ) * price_den <= static_cast<uint128_t>( reserve_in ) * price_num ) return 0;
+
+        const uint64_t N = 10000, n = N - fee;
+        const uint128_t r_in_sq = static_cast<uint128_t>( reserve_in ) * reserve_in;
+        const uint256 a = mul256( uint256{ 0, r_in_sq }, ( N - n ) * ( N - n ) );
+        const uint256 b = mul256( div256( mul256( uint256{ 0, static_cast<uint128_t>( reserve_in ) * reserve_out }, price_den ), price_num ), 4 * n * N );
+        const uint128_t root = sqrt( add256( a, b ) );
+
+        const uint128_t offset = static_cast<uint128_t>( N + n ) * reserve_in;
+        if ( root <= offset ) return 0;
+        const uint128_t x = ( root - offset ) / ( 2 * n );
+        check( x <= max_amount, "HamburgerLibrary: OVERFLOW" );
+        return static_cast<uint64_t>( x );
+    }
+
+    /**
+     * ## STATIC `get_price`
+     *
+     * Get spot price of reserve0 in units of reserve1 (`reserve1 / reserve0` as Q64.64)
+     *
+     * ### params
+     *
+     * - `{int64_t} reserve0` - reserve0
+     * - `{int64_t} reserve1` - reserve1
+     *
+     * ### returns
+     *
+     * - `{uint128_t}` - Q64.64 price
+     */
+    static uint128_t get_price( const int64_t reserve0, const int64_t reserve1 )
+    {
+        check( reserve0 > 0 && reserve1 > 0, "HamburgerLibrary: INSUFFICIENT_LIQUIDITY" );
+
+        return ( static_cast<uint128_t>( reserve1 ) << 64 ) / static_cast<uint64_t>( reserve0 );
+    }
+
+    /**
+     * ## STATIC `get_cumulative`
+     *
+     * Advance a cumulative price (Q64.64 price × seconds, wrapping) from the last observation to `now`
+     *
+     * The last observed price holds until `last_update_time` (when the pair reserves last changed), the
+     * current price from then on. Differences of cumulative prices stay exact modulo 2^128.
+     *
+     * ### params
+     *
+     * - `{uint128_t} cumulative` - cumulative price at last observation
+     * - `{uint128_t} last_price` - Q64.64 price at last observation
+     * - `{uint32_t} last_time` - time of last observation
+     * - `{uint128_t} price` - current Q64.64 price
+     * - `{uint32_t} last_update_time` - pair `last_update_time`
+     * - `{uint32_t} now` - current time
+     *
+     * ### returns
+     *
+     * - `{uint128_t}` - cumulative price at `now`
+     */
+    static uint128_t get_cumulative( const uint128_t cumulative, const uint128_t last_price, const uint32_t last_time, const uint128_t price, const uint32_t last_update_time, const uint32_t now )
+    {
+        check( now >= last_time, "HamburgerLibrary: INVALID_TIME" );
+
+        const uint32_t changed = std::min( std::max( last_update_time, last_time ), now );
+        return cumulative + last_price * ( changed - last_time ) + price * ( now - changed );
+    }
+
+    /**
+     * ## STATIC `get_average_price`
+     *
+     * Get time-weighted average price between two cumulative observations
+     *
+     * ### params
+     *
+     * - `{uint128_t} cumulative_start` - cumulative price at `start`
+     * - `{uint32_t} start` - start time
+     * - `{uint128_t} cumulative_end` - cumulative price at `end`
+     * - `{uint32_t} end` - end time
+     *
+     * ### returns
+     *
+     * - `{uint128_t}` - Q64.64 average price
+     */
+    static uint128_t get_average_price( const uint128_t cumulative_start, const uint32_t start, const uint128_t cumulative_end, const uint32_t end )
+    {
+        check( end > start, "HamburgerLibrary: INVALID_TIME" );
+
+        return ( cumulative_end - cumulative_start ) / ( end - start );
+    }
+
+    /**
+     * ## STATIC `get_price_amount`
+     *
+     * Convert an amount at a Q64.64 price (rounded down)
+     *
+     * ### params
+     *
+     * - `{uint64_t} amount` - amount
+     * - `{uint128_t} price` - Q64.64 price
+     *
+     * ### returns
+     *
+     * - `{uint64_t}` - `amount * price`
+     *
+     * ### example
+     *
+     * ```c++
+     * const uint64_t amount_out = hamburger::get_price_amount( 10000, hamburger::get_price( 45851931234, 125682033533 ) );
+     * // => 27410
+     * ```
+     */
+    static uint64_t get_price_amount( const uint64_t amount, const uint128_t price )
+    {
+        const uint256 res = mul256( price, amount );
+        check( res.hi == 0, "HamburgerLibrary: OVERFLOW" );
+
+        return static_cast<uint64_t>( res.lo >> 64 );
+    }
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+/**
+ * Off-chain reserve book of Hamburger pairs, pools, config & deposits
+ *
+ * Fed with SHiP deltas (`ship.hpp`). All deltas of a block are applied under a single writer lock so
+ * readers always observe the state of one whole block; changes of reversible blocks are kept in an undo
+ * log to roll back forks. SHiP only streams changes, bootstrap the book with `set_*` (ex: from
+ * `get_table_rows`) when not starting from the first block.
+ *
+ * Point reads never take the lock: pairs & pools are published to per-row seqlock slots and the block number
+ * with the config to a single atomic word (single writer, lock-free readers). `get_pair`, `get_pool`,
+ * `get_config` & `block_num` always return values of one block, retrying only while that row is rewritten.
+ * `get_deposit`, `for_each_pair` & `read_state` (whole-block walks) still take the reader lock.
+ */
+
+#include "ship.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+
+namespace hamburger { namespace offchain {
+
+    class reserve_book {
+    public:
+        reserve_book() { publish_head(); }
+        reserve_book( const reserve_book& ) = delete;
+        reserve_book& operator=( const reserve_book& ) = delete;
+
+        /**
+         * Apply deltas of one block (blocks at or below the current head roll back the fork first)
+         */
+        void apply( const ship::blocks_result& result )
+        {
+            if ( !result.this_block ) return;
+            const uint32_t block_num = result.this_block->block_num;
+
+            std::unique_lock lock( _mutex );
+            while ( !_undo.empty() && _undo.back().block_num >= block_num ) {
+                revert( _undo.back() );
+                _undo.pop_back();
+            }
+
+            undo_block undo;
+            undo.block_num = block_num;
+            for ( const ship::contract_row& row : result.rows ) {
+                if ( row.code == ship::code && row.table == ship::pairs_table ) {
+                    update( _state.pairs, undo.pairs, row.primary_key, row.present ? std::optional{ ship::decode_pair( row.value ) } : std::nullopt );
+                }
+                else if ( row.code == ship::code && row.table == ship::deposits_table ) {
+                    update( _state.deposits, undo.deposits, deposit_key{ row.scope, row.primary_key }, row.present ? std::optional{ ship::decode_deposit( row.value ) } : std::nullopt );
+                }
+                else if ( row.code == ship::mine_code && row.table == ship::pools_table ) {
+                    update( _state.pools, undo.pools, row.primary_key, row.present ? std::optional{ ship::decode_pool( row.value ) } : std::nullopt );
+                }
+                else if ( row.code == ship::code && row.table == ship::config_table ) {
+                    if ( !undo.config ) undo.config = _state.config;
+                    _state.config = row.present ? std::optional{ ship::decode_config( row.value ) } : std::nullopt;
+                }
+            }
+            for ( const auto& [ id, value ] : undo.pairs ) publish_pair( id, block_num );
+            for ( const auto& [ id, value ] : undo.pools ) publish_pool( id, block_num );
+            _undo.push_back( std::move( undo ) );
+            _block_num = block_num;
+            publish_head();
+
+            // irreversible blocks can no longer be rolled back
+            while ( !_undo.empty() && _undo.front().block_num <= result.last_irreversible.block_num ) _undo.pop_front();
+        }
+
+        /**
+         * Bootstrap rows (ex: from `get_table_rows`) before streaming
+         */
+        void set_pair( const pair_state& pair ) { std::unique_lock lock( _mutex ); _state.pairs[pair.id] = pair; publish_pair( pair.id, _block_num ); }
+        void set_pool( const pool_state& pool ) { std::unique_lock lock( _mutex ); _state.pools[pool.pair_id] = pool; publish_pool( pool.pair_id, _block_num ); }
+        void set_config( const config_state& config ) { std::unique_lock lock( _mutex ); _state.config = config; publish_head(); }
+        void set_deposit( const uint64_t scope, const deposit_state& deposit ) { std::unique_lock lock( _mutex ); _state.deposits[deposit_key{ scope, deposit.owner }] = deposit; }
+        void set_block_num( const uint32_t block_num ) { std::unique_lock lock( _mutex ); _block_num = block_num; publish_head(); }
+
+        /**
+         * Last applied block number (lock-free)
+         */
+        uint32_t block_num() const { return _head.load( std::memory_order_acquire ) >> 32; }
+
+        /**
+         * Lock-free read of the config (`block_num` => block of this config)
+         */
+        config_state get_config( uint32_t* block_num = nullptr ) const
+        {
+            const uint64_t head = _head.load( std::memory_order_acquire );
+            if ( block_num ) *block_num = head >> 32;
+            return { static_cast<uint8_t>( head >> 24 ), static_cast<uint8_t>( head >> 16 ), static_cast<uint8_t>( head >> 8 ), static_cast<uint8_t>( head ) };
+        }
+
+        /**
+         * Lock-free read of a pair (`block_num` => block of these reserves, pair ids past the slots fall back to the lock)
+         */
+        std::optional<pair_state> get_pair( const uint64_t pair_id, uint32_t* block_num = nullptr ) const
+        {
+            std::array<uint64_t, pair_fields> f;
+            if ( !_pair_slots.covers( pair_id ) ) {
+                std::shared_lock lock( _mutex );
+                if ( block_num ) *block_num = _block_num;
+                return find( _state.pairs, pair_id );
+            }
+            if ( !_pair_slots.read( pair_id, f ) ) f[8] = static_cast<uint64_t>( this->block_num() ) << 32;   // never written => absent
+            if ( block_num ) *block_num = static_cast<uint32_t>( f[8] >> 32 );
+            if ( !( f[8] & 1 ) ) return std::nullopt;
+            return pair_state{ pair_id, f[0], f[1], static_cast<int64_t>( f[2] ), static_cast<int64_t>( f[3] ), f[4], static_cast<uint32_t>( f[5] ), f[6], f[7] };
+        }
+
+        /**
+         * Lock-free read of a pool (same block guarantee & fallback as `get_pair`)
+         */
+        std::optional<pool_state> get_pool( const uint64_t pair_id, uint32_t* block_num = nullptr ) const
+        {
+            std::array<uint64_t, pool_fields> f;
+            if ( !_pool_slots.covers( pair_id ) ) {
+                std::shared_lock lock( _mutex );
+                if ( block_num ) *block_num = _block_num;
+                return find( _state.pools, pair_id );
+            }
+            if ( !_pool_slots.read( pair_id, f ) ) f[5] = static_cast<uint64_t>( this->block_num() ) << 32;
+            if ( block_num ) *block_num = static_cast<uint32_t>( f[5] >> 32 );
+            if ( !( f[5] & 1 ) ) return std::nullopt;
+            double weight;
+            std::memcpy( &weight, &f[0], sizeof( weight ) );
+            return pool_state{ pair_id, weight, static_cast<int64_t>( f[1] ), static_cast<uint32_t>( f[2] ), static_cast<uint32_t>( f[3] ), static_cast<uint32_t>( f[4] ) };
+        }
+
+        std::optional<deposit_state> get_deposit( const uint64_t owner, const uint64_t scope = ship::code ) const { std::shared_lock lock( _mutex ); return find( _state.deposits, deposit_key{ scope, owner } ); }
+
+        /**
+         * Visit every pair of a single block state (reader lock held during the walk)
+         */
+        template <typename F>
+        void for_each_pair( F&& visit ) const
+        {
+            std::shared_lock lock( _mutex );
+            for ( const auto& [ id, pair ] : _state.pairs ) visit( pair );
+        }
+
+        /**
+         * Read block number, config, pairs & pools of a single block state at once (reader lock held)
+         *
+         * `visit( block_num, config, pairs, pools )` with pairs & pools as `std::map` keyed by pair id
+         */
+        template <typename F>
+        void read_state( F&& visit ) const
+        {
+            std::shared_lock lock( _mutex );
+            visit( _block_num, _state.config.value_or( config_state{} ), _state.pairs, _state.pools );
+        }
+
+    private:
+        using deposit_key = std::pair<uint64_t, uint64_t>;  // scope, owner
+
+        // per-id seqlock slots of `N` words (single writer, lock-free readers), chunks allocated on first write
+        template <size_t N>
+        class seqlock_slots {
+        public:
+            static constexpr size_t chunk_size = 256;
+            static constexpr size_t max_chunks = 4096;      // ids below 1,048,576 are lock-free
+
+            seqlock_slots() = default;
+            seqlock_slots( const seqlock_slots& ) = delete;
+            seqlock_slots& operator=( const seqlock_slots& ) = delete;
+
+            ~seqlock_slots()
+            {
+                for ( auto& chunk : _chunks ) delete[] chunk.load( std::memory_order_relaxed );
+            }
+
+            static bool covers( const uint64_t id ) { return id < chunk_size * max_chunks; }
+
+            // false if the slot was never written
+            bool read( const uint64_t id, std::array<uint64_t, N>& fields ) const
+            {
+                const slot* chunk = _chunks[id / chunk_size].load( std::memory_order_acquire );
+                if ( !chunk ) return false;
+                const slot& s = chunk[id % chunk_size];
+                while ( true ) {
+                    const uint32_t seq = s.seq.load( std::memory_order_acquire );
+                    if ( seq & 1 ) continue;
+                    for ( size_t i = 0; i < N; ++i ) fields[i] = s.fields[i].load( std::memory_order_relaxed );
+                    std::atomic_thread_fence( std::memory_order_acquire );
+                    if ( s.seq.load( std::memory_order_relaxed ) == seq ) return seq != 0;
+                }
+            }
+
+            void write( const uint64_t id, const std::array<uint64_t, N>& fields )
+            {
+                std::atomic<slot*>& chunk = _chunks[id / chunk_size];
+                if ( !chunk.load( std::memory_order_relaxed ) ) chunk.store( new slot[chunk_size], std::memory_order_release );
+                slot& s = chunk.load( std::memory_order_relaxed )[id % chunk_size];
+
+                const uint32_t seq = s.seq.load( std::memory_order_relaxed );
+                s.seq.store( seq + 1, std::memory_order_relaxed );
+                std::atomic_thread_fence( std::memory_order_release );
+                for ( size_t i = 0; i < N; ++i ) s.fields[i].store( fields[i], std::memory_order_relaxed );
+                s.seq.store( seq + 2, std::memory_order_release );
+            }
+
+        private:
+            // odd `seq` => write in progress, 0 => never written
+            struct slot {
+                std::atomic<uint32_t>                       seq{ 0 };
+                std::array<std::atomic<uint64_t>, N>        fields{};
+            };
+            std::array<std::atomic<slot*>, max_chunks>      _chunks{};
+        };
+
+        // pair: symbol0, symbol1, reserve0, reserve1, total_liquidity, last_update_time, contract0, contract1, block_num << 32 | present
+        static constexpr size_t pair_fields = 9;
+        // pool: weight (bits), balance, last_issue_time, start_time, end_time, block_num << 32 | present
+        static constexpr size_t pool_fields = 6;
+
+        struct state {
+            std::map<uint64_t, pair_state>          pairs;
+            std::map<uint64_t, pool_state>          pools;
+            std::map<deposit_key, deposit_state>    deposits;
+            std::optional<config_state>             config;
+        };
+
+        // previous value of every row touched by a block (nullopt => row did not exist)
+        struct undo_block {
+            uint32_t                                            block_num = 0;
+            std::map<uint64_t, std::optional<pair_state>>       pairs;
+            std::map<uint64_t, std::optional<pool_state>>       pools;
+            std::map<deposit_key, std::optional<deposit_state>> deposits;
+            std::optional<std::optional<config_state>>          config;
+        };
+
+        template <typename K, typename T>
+        static std::optional<T> find( const std::map<K, T>& rows, const K& key )
+        {
+            const auto itr = rows.find( key );
+            if ( itr == rows.end() ) return std::nullopt;
+            return itr->second;
+        }
+
+        template <typename K, typename T>
+        static void update( std::map<K, T>& rows, std::map<K, std::optional<T>>& undo, const K& key, const std::optional<T>& value )
+        {
+            undo.emplace( key, find( rows, key ) );     // keeps the first (pre-block) value
+            if ( value ) rows[key] = *value;
+            else rows.erase( key );
+        }
+
+        template <typename K, typename T>
+        static void restore( std::map<K, T>& rows, const std::map<K, std::optional<T>>& undo )
+        {
+            for ( const auto& [ key, value ] : undo ) {
+                if ( value ) rows[key] = *value;
+                else rows.erase( key );
+            }
+        }
+
+        void revert( const undo_block& undo )
+        {
+            restore( _state.pairs, undo.pairs );
+            restore( _state.pools, undo.pools );
+            restore( _state.deposits, undo.deposits );
+            if ( undo.config ) _state.config = *undo.config;
+            _block_num = undo.block_num - 1;
+            for ( const auto& [ id, value ] : undo.pairs ) publish_pair( id, _block_num );
+            for ( const auto& [ id, value ] : undo.pools ) publish_pool( id, _block_num );
+            publish_head();
+        }
+
+        // copy rows of `_state` into their slots (writer lock held, so a single writer)
+        void publish_pair( const uint64_t pair_id, const uint32_t block_num )
+        {
+            if ( !_pair_slots.covers( pair_id ) ) return;
+            const auto pair = find( _state.pairs, pair_id );
+            const pair_state p = pair.value_or( pair_state{} );
+            _pair_slots.write( pair_id, {
+                p.symbol0, p.symbol1, static_cast<uint64_t>( p.reserve0 ), static_cast<uint64_t>( p.reserve1 ), p.total_liquidity,
+                p.last_update_time, p.contract0, p.contract1, static_cast<uint64_t>( block_num ) << 32 | ( pair ? 1 : 0 )
+            });
+        }
+
+        void publish_pool( const uint64_t pair_id, const uint32_t block_num )
+        {
+            if ( !_pool_slots.covers( pair_id ) ) return;
+            const auto pool = find( _state.pools, pair_id );
+            const pool_state p = pool.value_or( pool_state{} );
+            uint64_t weight;
+            std::memcpy( &weight, &p.weight, sizeof( weight ) );
+            _pool_slots.write( pair_id, {
+                weight, static_cast<uint64_t>( p.balance ), p.last_issue_time, p.start_time, p.end_time,
+                static_cast<uint64_t>( block_num ) << 32 | ( pool ? 1 : 0 )
+            });
+        }
+
+        // block number & config as one word: block_num << 32 | contract_status, mine_status, trade_fee, protocol_fee
+        void publish_head()
+        {
+            const config_state config = _state.config.value_or( config_state{} );
+            _head.store( static_cast<uint64_t>( _block_num ) << 32 | static_cast<uint64_t>( config.contract_status ) << 24
+                | static_cast<uint64_t>( config.mine_status ) << 16 | static_cast<uint64_t>( config.trade_fee ) << 8 | config.protocol_fee, std::memory_order_release );
+        }
+
+        mutable std::shared_mutex                   _mutex;
+        state                                       _state;
+        std::deque<undo_block>                      _undo;
+        uint32_t                                    _block_num = 0;
+        std::atomic<uint64_t>                       _head{ 0 };
+        seqlock_slots<pair_fields>                  _pair_slots;
+        seqlock_slots<pool_fields>                  _pool_slots;
+    };
+} }
@@ -0,0 +1,266 @@
+#pragma once
+
+/**
+ * Memory-mapped snapshot of a `reserve_book`
+ *
+ * Fixed layout file: a header (magic, version, capacity, block number watermark, dirty flag, config)
+ * followed by structure-of-arrays columns of `capacity` slots indexed by `pairs_row::id` for pairs
+ * (`pools` share the same slots, keyed by `pair_id`). A restart maps the file, restores the book and
+ * resumes streaming from `block_num() + 1`. Deposits are not persisted. POSIX only.
+ *
+ * The watermark is only valid while the dirty flag is clear: `save` raises the flag, rewrites the
+ * columns, stores the block number then clears the flag and `msync`s; a file left dirty by a crash is
+ * ignored by `load`. Reversible blocks are saved as-is, stream with `irreversible_only` when the book
+ * must survive forks across restarts.
+ */
+
+#include "book.hpp"
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace hamburger { namespace offchain {
+
+    class book_file {
+    public:
+        static constexpr uint64_t magic = 0x4b4f4f4247424820;   // " HBGBOOK"
+        static constexpr uint32_t version = 1;
+
+        /**
+         * Open or create the file at `path` (existing files keep their capacity, grows on `save`)
+         */
+        book_file( const std::string& path, const uint32_t capacity = 4096 )
+        {
+            _fd = ::open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+            if ( _fd < 0 ) throw std::runtime_error( "book_file: cannot open " + path );
+
+            // the destructor does not run when the constructor throws
+            try {
+                struct stat st;
+                if ( ::fstat( _fd, &st ) != 0 ) throw std::runtime_error( "book_file: cannot stat " + path );
+                if ( static_cast<size_t>( st.st_size ) >= sizeof( header ) ) {
+                    map( static_cast<size_t>( st.st_size ) );
+                    if ( _header->magic != magic || _header->version != version || file_size( _header->capacity ) != _size ) throw std::runtime_error( "book_file: invalid file " + path );
+                }
+                else resize( capacity );
+            }
+            catch ( ... ) {
+                close();
+                throw;
+            }
+        }
+
+        ~book_file() { close(); }
+
+        book_file( const book_file& ) = delete;
+        book_file& operator=( const book_file& ) = delete;
+
+        /**
+         * Write the current book state (a single block) and flush it to disk
+         *
+         * Rows are copied under the book reader lock, the file is written & flushed after releasing it
+         * (`apply` never waits on the disk).
+         */
+        void save( const reserve_book& book )
+        {
+            uint32_t block_num = 0;
+            config_state config;
+            std::vector<pair_state> pairs;
+            std::vector<pool_state> pools;
+            book.read_state( [&]( const uint32_t num, const config_state& cfg, const auto& pair_rows, const auto& pool_rows ) {
+                block_num = num;
+                config = cfg;
+                pairs.reserve( pair_rows.size() );
+                for ( const auto& [ id, pair ] : pair_rows ) pairs.push_back( pair );
+                pools.reserve( pool_rows.size() );
+                for ( const auto& [ id, pool ] : pool_rows ) pools.push_back( pool );
+            });
+
+            uint64_t max_id = 0;
+            if ( !pairs.empty() ) max_id = pairs.back().id;
+            if ( !pools.empty() ) max_id = std::max( max_id, pools.back().pair_id );
+            if ( max_id >= _header->capacity ) {
+                if ( max_id >= 0xffffffff / 2 ) throw std::runtime_error( "book_file: pair id out of range" );
+                uint32_t capacity = _header->capacity;
+                while ( capacity <= max_id ) capacity *= 2;
+                resize( capacity );
+            }
+
+            _header->dirty = 1;
+            ::msync( _data, sizeof( header ), MS_SYNC );
+
+            const columns c = layout();
+            std::memset( c.pair_present, 0, _header->capacity );
+            std::memset( c.pool_present, 0, _header->capacity );
+            for ( const pair_state& pair : pairs ) {
+                const uint64_t id = pair.id;
+                c.symbol0[id] = pair.symbol0;
+                c.symbol1[id] = pair.symbol1;
+                c.contract0[id] = pair.contract0;
+                c.contract1[id] = pair.contract1;
+                c.reserve0[id] = pair.reserve0;
+                c.reserve1[id] = pair.reserve1;
+                c.total_liquidity[id] = pair.total_liquidity;
+                c.last_update_time[id] = pair.last_update_time;
+                c.pair_present[id] = 1;
+            }
+            for ( const pool_state& pool : pools ) {
+                const uint64_t id = pool.pair_id;
+                c.weight[id] = pool.weight;
+                c.balance[id] = pool.balance;
+                c.last_issue_time[id] = pool.last_issue_time;
+                c.start_time[id] = pool.start_time;
+                c.end_time[id] = pool.end_time;
+                c.pool_present[id] = 1;
+            }
+            _header->config[0] = config.contract_status;
+            _header->config[1] = config.mine_status;
+            _header->config[2] = config.trade_fee;
+            _header->config[3] = config.protocol_fee;
+            _header->block_num = block_num;
+            ::msync( _data, _size, MS_SYNC );
+
+            _header->dirty = 0;
+            ::msync( _data, sizeof( header ), MS_SYNC );
+        }
+
+        /**
+         * Restore pairs, pools, config & block number into `book` (false when nothing valid was saved)
+         */
+        bool load( reserve_book& book ) const
+        {
+            if ( _header->dirty || _header->block_num == 0 ) return false;
+
+            const columns c = layout();
+            book.set_block_num( _header->block_num );          // first, so restored pairs are published at this block
+            for ( uint32_t id = 0; id < _header->capacity; ++id ) {
+                if ( c.pair_present[id] ) book.set_pair( pair_state{ id, c.symbol0[id], c.symbol1[id], c.reserve0[id], c.reserve1[id], c.total_liquidity[id], c.last_update_time[id], c.contract0[id], c.contract1[id] } );
+                if ( c.pool_present[id] ) book.set_pool( pool_state{ id, c.weight[id], c.balance[id], c.last_issue_time[id], c.start_time[id], c.end_time[id] } );
+            }
+            book.set_config( config_state{ _header->config[0], _header->config[1], _header->config[2], _header->config[3] } );
+            return true;
+        }
+
+        /**
+         * Block number watermark of the last completed `save` (0 when none)
+         */
+        uint32_t block_num() const { return _header->dirty ? 0 : _header->block_num; }
+
+        uint32_t capacity() const { return _header->capacity; }
+
+    private:
+        struct header {
+            uint64_t    magic;
+            uint32_t    version;
+            uint32_t    capacity;
+            uint32_t    block_num;
+            uint32_t    dirty;
+            uint8_t     config[4];                      // contract_status, mine_status, trade_fee, protocol_fee
+            uint8_t     reserved[36];
+        };
+        static_assert( sizeof( header ) == 64 );
+
+        // 8 byte columns first, then 4 byte, then 1 byte (every column stays naturally aligned)
+        struct columns {
+            uint64_t*   symbol0;
+            uint64_t*   symbol1;
+            uint64_t*   contract0;
+            uint64_t*   contract1;
+            int64_t*    reserve0;
+            int64_t*    reserve1;
+            uint64_t*   total_liquidity;
+            double*     weight;
+            int64_t*    balance;
+            uint32_t*   last_update_time;
+            uint32_t*   last_issue_time;
+            uint32_t*   start_time;
+            uint32_t*   end_time;
+            uint8_t*    pair_present;
+            uint8_t*    pool_present;
+        };
+
+        static size_t file_size( const uint64_t capacity )
+        {
+            return sizeof( header ) + capacity * ( 9 * 8 + 4 * 4 + 2 );
+        }
+
+        columns layout() const
+        {
+            const size_t n = _header->capacity;
+            char* p = _data + sizeof( header );
+            const auto next = [&]( auto* type, const size_t width ) {
+                auto* column = reinterpret_cast<decltype( type )>( p );
+                p += n * width;
+                return column;
+            };
+            columns c;
+            c.symbol0 = next( c.symbol0, 8 );
+            c.symbol1 = next( c.symbol1, 8 );
+            c.contract0 = next( c.contract0, 8 );
+            c.contract1 = next( c.contract1, 8 );
+            c.reserve0 = next( c.reserve0, 8 );
+            c.reserve1 = next( c.reserve1, 8 );
+            c.total_liquidity = next( c.total_liquidity, 8 );
+            c.weight = next( c.weight, 8 );
+            c.balance = next( c.balance, 8 );
+            c.last_update_time = next( c.last_update_time, 4 );
+            c.last_issue_time = next( c.last_issue_time, 4 );
+            c.start_time = next( c.start_time, 4 );
+            c.end_time = next( c.end_time, 4 );
+            c.pair_present = next( c.pair_present, 1 );
+            c.pool_present = next( c.pool_present, 1 );
+            return c;
+        }
+
+        // (re)create an empty file of `capacity` slots
+        void resize( const uint32_t capacity )
+        {
+            if ( capacity == 0 ) throw std::runtime_error( "book_file: capacity must be positive" );
+            unmap();
+            const size_t size = file_size( capacity );
+            if ( ::ftruncate( _fd, 0 ) != 0 || ::ftruncate( _fd, size ) != 0 ) throw std::runtime_error( "book_file: cannot resize" );
+            map( size );
+            _header->magic = magic;
+            _header->version = version;
+            _header->capacity = capacity;
+            _header->block_num = 0;
+            _header->dirty = 0;
+        }
+
+        void map( const size_t size )
+        {
+            void* data = ::mmap( nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, _fd, 0 );
+            if ( data == MAP_FAILED ) throw std::runtime_error( "book_file: cannot map" );
+            _data = static_cast<char*>( data );
+            _size = size;
+            _header = reinterpret_cast<header*>( _data );
+        }
+
+        void unmap()
+        {
+            if ( _data ) ::munmap( _data, _size );
+            _data = nullptr;
+            _header = nullptr;
+            _size = 0;
+        }
+
+        void close()
+        {
+            unmap();
+            if ( _fd >= 0 ) ::close( _fd );
+            _fd = -1;
+        }
+
+        int         _fd = -1;
+        char*       _data = nullptr;
+        size_t      _size = 0;
+        header*     _header = nullptr;
+    };
+} }
@@ -0,0 +1,261 @@
+#pragma once
+
+/**
+ * Cross-DEX reserve providers, pipelined fetcher & best-route selector
+ *
+ * Every DEX following the uniswap-style pair shape (Hamburger, Defibox, ...) is exposed through a common
+ * `reserve_provider` returning `pair_state` rows & a fee. The `fetcher` refreshes all providers
+ * concurrently, either once (`refresh`) or continuously with one thread per provider (`start`), each
+ * publishing its latest `market` independently so a slow DEX never delays the others (a failing provider keeps
+ * its last market and reports the error through `errors`). `best_route`
+ * compares direct & 2-hop routes across all markets (hops may mix DEXes) with the exact integer quotes.
+ * Native only, link with `-pthread`.
+ */
+
+#include "book.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <exception>
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace hamburger { namespace offchain {
+
+    /**
+     * Pairs of one DEX at one point in time
+     */
+    struct market {
+        std::string                 dex;
+        uint8_t                     fee = 0;
+        uint32_t                    block_num = 0;      // 0 if unknown
+        std::vector<pair_state>     pairs;
+    };
+
+    class reserve_provider {
+    public:
+        virtual ~reserve_provider() = default;
+
+        /**
+         * Read the current pairs of the DEX (may block on I/O, called from fetcher threads)
+         */
+        virtual market fetch() = 0;
+    };
+
+    /**
+     * Hamburger pairs from a SHiP-fed `reserve_book` (no I/O, a single block state)
+     */
+    class hamburger_provider : public reserve_provider {
+    public:
+        explicit hamburger_provider( const reserve_book& book ) : _book( book ) {}
+
+        market fetch() override
+        {
+            market res;
+            res.dex = "hamburger";
+            _book.read_state( [&]( const uint32_t block_num, const config_state& config, const auto& pairs, const auto& ) {
+                res.fee = get_fee( config );
+                res.block_num = block_num;
+                res.pairs.reserve( pairs.size() );
+                for ( const auto& [ id, pair ] : pairs ) res.pairs.push_back( pair );
+            });
+            return res;
+        }
+
+    private:
+        const reserve_book&     _book;
+    };
+
+    /**
+     * Any other DEX through a fetch function (ex: `get_table_rows` of its `pairs` table over HTTP)
+     */
+    class function_provider : public reserve_provider {
+    public:
+        explicit function_provider( std::function<market()> fetch ) : _fetch( std::move( fetch ) ) {}
+
+        market fetch() override { return _fetch(); }
+
+    private:
+        std::function<market()>     _fetch;
+    };
+
+    class fetcher {
+    public:
+        explicit fetcher( std::vector<std::shared_ptr<reserve_provider>> providers )
+            : _providers( std::move( providers ) ), _markets( _providers.size() ), _errors( _providers.size() ) {}
+
+        ~fetcher() { stop(); }
+
+        /**
+         * Fetch every provider concurrently once (errors are recorded, then the first one is rethrown)
+         */
+        void refresh()
+        {
+            std::vector<std::future<market>> pending;
+            for ( auto& provider : _providers ) pending.push_back( std::async( std::launch::async, [&]() { return provider->fetch(); } ) );
+            std::exception_ptr first;
+            for ( size_t i = 0; i < pending.size(); ++i ) {
+                try { publish( i, pending[i].get() ); }
+                catch ( const std::exception& e ) {
+                    fail( i, e.what() );
+                    if ( !first ) first = std::current_exception();
+                }
+            }
+            if ( first ) std::rethrow_exception( first );
+        }
+
+        /**
+         * Keep refreshing every provider on its own thread (`interval` between fetches, errors are recorded & retry)
+         */
+        void start( const std::chrono::milliseconds interval )
+        {
+            if ( !_threads.empty() ) throw std::logic_error( "fetcher: already started" );
+            _stop = false;
+            for ( size_t i = 0; i < _providers.size(); ++i ) {
+                _threads.emplace_back( [this, i, interval]() {
+                    std::unique_lock lock( _wait_mutex );
+                    while ( !_stop ) {
+                        lock.unlock();
+                        try { publish( i, _providers[i]->fetch() ); }
+                        catch ( const std::exception& e ) { fail( i, e.what() ); }
+                        lock.lock();
+                        _wake.wait_for( lock, interval, [this]() { return _stop; } );
+                    }
+                });
+            }
+        }
+
+        /**
+         * Stop the provider threads (wakes them up, returns once the current fetches finish)
+         */
+        void stop()
+        {
+            {
+                std::lock_guard lock( _wait_mutex );
+                _stop = true;
+            }
+            _wake.notify_all();
+            for ( std::thread& thread : _threads ) thread.join();
+            _threads.clear();
+        }
+
+        /**
+         * Latest published market of every provider (null until the first fetch)
+         */
+        std::vector<std::shared_ptr<const market>> latest() const
+        {
+            std::vector<std::shared_ptr<const market>> res;
+            for ( const auto& m : _markets ) res.push_back( std::atomic_load( &m ) );
+            return res;
+        }
+
+        /**
+         * Error of the last fetch of every provider (empty if it succeeded, its market in `latest` is then current)
+         */
+        std::vector<std::string> errors() const
+        {
+            std::vector<std::string> res;
+            for ( const auto& e : _errors ) {
+                const auto error = std::atomic_load( &e );
+                res.push_back( error ? *error : std::string{} );
+            }
+            return res;
+        }
+
+    private:
+        void publish( const size_t i, market m )
+        {
+            std::atomic_store( &_markets[i], std::shared_ptr<const market>( std::make_shared<market>( std::move( m ) ) ) );
+            std::atomic_store( &_errors[i], std::shared_ptr<const std::string>() );
+        }
+
+        void fail( const size_t i, const std::string& error )
+        {
+            std::atomic_store( &_errors[i], std::shared_ptr<const std::string>( std::make_shared<std::string>( error ) ) );
+        }
+
+        std::vector<std::shared_ptr<reserve_provider>>  _providers;
+        std::vector<std::shared_ptr<const market>>      _markets;
+        std::vector<std::shared_ptr<const std::string>> _errors;
+        std::vector<std::thread>                        _threads;
+        std::mutex                                      _wait_mutex;
+        std::condition_variable                         _wake;
+        bool                                            _stop = false;      // guarded by `_wait_mutex`
+    };
+
+    /**
+     * Token of a market (raw symbol & contract name value)
+     */
+    struct token {
+        uint64_t    symbol = 0;
+        uint64_t    contract = 0;
+
+        friend bool operator<( const token& a, const token& b ) { return a.symbol < b.symbol || ( a.symbol == b.symbol && a.contract < b.contract ); }
+        friend bool operator==( const token& a, const token& b ) { return a.symbol == b.symbol && a.contract == b.contract; }
+    };
+
+    /**
+     * Route of up to two hops (`market` indexes into the markets given to `best_route`)
+     */
+    struct route {
+        struct hop {
+            size_t      market = 0;
+            uint64_t    pair_id = 0;
+            bool        reverse = false;            // trading from reserve1
+        };
+        std::vector<hop>    hops;
+        uint64_t            amount_out = 0;
+    };
+
+    /**
+     * Best direct or 2-hop route across markets for an input amount (amount_out 0 if none)
+     */
+    static route best_route( const std::vector<std::shared_ptr<const market>>& markets, const token in, const token out, const uint64_t amount_in )
+    {
+        struct edge {
+            route::hop      hop;
+            token           to;
+            int64_t         reserve_in;
+            int64_t         reserve_out;
+            uint8_t         fee;
+        };
+        std::map<token, std::vector<edge>> edges;
+        for ( size_t m = 0; m < markets.size(); ++m ) {
+            if ( !markets[m] ) continue;
+            for ( const pair_state& pair : markets[m]->pairs ) {
+                if ( pair.reserve0 <= 0 || pair.reserve1 <= 0 ) continue;
+                const token t0{ pair.symbol0, pair.contract0 }, t1{ pair.symbol1, pair.contract1 };
+                edges[t0].push_back( { { m, pair.id, false }, t1, pair.reserve0, pair.reserve1, markets[m]->fee } );
+                edges[t1].push_back( { { m, pair.id, true }, t0, pair.reserve1, pair.reserve0, markets[m]->fee } );
+            }
+        }
+
+        route best;
+        const auto from = edges.find( in );
+        if ( from == edges.end() ) return best;
+        for ( const edge& first : from->second ) {
+            const uint64_t mid = get_amount_out( amount_in, first.reserve_in, first.reserve_out, first.fee );
+            if ( first.to == out ) {
+                if ( mid > best.amount_out ) best = { { first.hop }, mid };
+                continue;
+            }
+            if ( mid == 0 ) continue;
+            const auto next = edges.find( first.to );
+            if ( next == edges.end() ) continue;
+            for ( const edge& second : next->second ) {
+                if ( !( second.to == out ) ) continue;
+                const uint64_t amount = get_amount_out( mid, second.reserve_in, second.reserve_out, second.fee );
+                if ( amount > best.amount_out ) best = { { first.hop, second.hop }, amount };
+            }
+        }
+        return best;
+    }
+} }
@@ -0,0 +1,150 @@
+#pragma once
+
+/**
+ * Structure-of-arrays store of Hamburger pairs for batch quoting
+ *
+ * One column per field (`reserve0[]`, `reserve1[]`, precisions, ids) so quoting a fixed input against every
+ * pair streams contiguous memory. `quote_out` is the vectorized screening kernel (AVX2 / NEON, scalar
+ * fallback) in double precision; `quote_out_exact` & `get_amount_out` return the exact integer amounts of
+ * `math.hpp` for the candidates that pass the screen. Native only.
+ */
+
+#include "../math.hpp"
+
+#include <cmath>
+#include <unordered_map>
+#include <vector>
+
+#if defined( __AVX2__ )
+#include <immintrin.h>
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+#include <arm_neon.h>
+#endif
+
+namespace hamburger { namespace offchain {
+
+    class pair_store {
+    public:
+        explicit pair_store( const uint8_t fee = get_fee( config_state{} ) ) : _fee( fee ) {}
+
+        /**
+         * Build from any range of `pair_state` (ex: `to_state( pairs_row )` or a `reserve_book` walk)
+         */
+        template <typename It>
+        pair_store( It first, It last, const uint8_t fee ) : _fee( fee )
+        {
+            for ( ; first != last; ++first ) set( *first );
+        }
+
+        /**
+         * Insert or update the reserves of a pair
+         */
+        void set( const pair_state& pair )
+        {
+            const auto [ itr, inserted ] = _slots.try_emplace( pair.id, _ids.size() );
+            if ( inserted ) {
+                _ids.push_back( pair.id );
+                for ( auto* column : { &_reserve0, &_reserve1 } ) column->push_back( 0 );
+                for ( auto* column : { &_reserve0d, &_reserve1d } ) column->push_back( 0 );
+                _precision0.push_back( 0 );
+                _precision1.push_back( 0 );
+            }
+            const size_t i = itr->second;
+            _reserve0[i] = pair.reserve0;
+            _reserve1[i] = pair.reserve1;
+            _precision0[i] = pair.symbol0 & 0xff;
+            _precision1[i] = pair.symbol1 & 0xff;
+
+            // empty pairs quote 0 in the screening kernel
+            const bool liquid = pair.reserve0 > 0 && pair.reserve1 > 0;
+            _reserve0d[i] = liquid ? static_cast<double>( pair.reserve0 ) : 0;
+            _reserve1d[i] = liquid ? static_cast<double>( pair.reserve1 ) : 0;
+        }
+
+        void set_fee( const uint8_t fee ) { _fee = fee; }
+        uint8_t fee() const { return _fee; }
+
+        size_t size() const { return _ids.size(); }
+
+        /**
+         * Slot of a pair id (-1 if unknown)
+         */
+        int64_t slot( const uint64_t pair_id ) const
+        {
+            const auto itr = _slots.find( pair_id );
+            return itr == _slots.end() ? -1 : static_cast<int64_t>( itr->second );
+        }
+
+        const std::vector<uint64_t>& ids() const { return _ids; }
+        const std::vector<int64_t>& reserve0() const { return _reserve0; }
+        const std::vector<int64_t>& reserve1() const { return _reserve1; }
+        const std::vector<uint8_t>& precision0() const { return _precision0; }
+        const std::vector<uint8_t>& precision1() const { return _precision1; }
+
+        /**
+         * Exact amount out of slot `i` (`reverse` => reserve1 is the input side), 0 without liquidity
+         */
+        uint64_t get_amount_out( const size_t i, const bool reverse, const uint64_t amount_in ) const
+        {
+            const int64_t reserve_in = reverse ? _reserve1[i] : _reserve0[i];
+            const int64_t reserve_out = reverse ? _reserve0[i] : _reserve1[i];
+            if ( reserve_in <= 0 || reserve_out <= 0 ) return 0;
+            return hamburger::get_amount_out( amount_in, reserve_in, reserve_out, _fee );
+        }
+
+        /**
+         * Exact amount out of every pair for the same `amount_in` (scalar), `out` holds `size()` amounts
+         */
+        void quote_out_exact( const uint64_t amount_in, const bool reverse, uint64_t* out ) const
+        {
+            check( amount_in > 0, "HamburgerLibrary: INSUFFICIENT_INPUT_AMOUNT" );
+            for ( size_t i = 0; i < _ids.size(); ++i ) out[i] = get_amount_out( i, reverse, amount_in );
+        }
+
+        /**
+         * Approximate amount out of every pair for the same `amount_in` (vectorized, within a few units of
+         * `quote_out_exact` for pair reserves up to 2^53), `out` holds `size()` amounts
+         */
+        void quote_out( const uint64_t amount_in, const bool reverse, double* out ) const
+        {
+            check( amount_in > 0, "HamburgerLibrary: INSUFFICIENT_INPUT_AMOUNT" );
+            const double* reserve_in = reverse ? _reserve1d.data() : _reserve0d.data();
+            const double* reserve_out = reverse ? _reserve0d.data() : _reserve1d.data();
+            const double in_with_fee = static_cast<double>( amount_in ) * ( 10000 - _fee );
+            const size_t n = _ids.size();
+            size_t i = 0;
+
+#if defined( __AVX2__ )
+            const __m256d fin = _mm256_set1_pd( in_with_fee );
+            const __m256d N = _mm256_set1_pd( 10000 );
+            for ( ; i + 4 <= n; i += 4 ) {
+                const __m256d r_in = _mm256_loadu_pd( reserve_in + i );
+                const __m256d r_out = _mm256_loadu_pd( reserve_out + i );
+                const __m256d denominator = _mm256_add_pd( _mm256_mul_pd( r_in, N ), fin );
+                _mm256_storeu_pd( out + i, _mm256_floor_pd( _mm256_div_pd( _mm256_mul_pd( fin, r_out ), denominator ) ) );
+            }
+#elif defined( __ARM_NEON ) && defined( __aarch64__ )
+            const float64x2_t fin = vdupq_n_f64( in_with_fee );
+            const float64x2_t N = vdupq_n_f64( 10000 );
+            for ( ; i + 2 <= n; i += 2 ) {
+                const float64x2_t r_in = vld1q_f64( reserve_in + i );
+                const float64x2_t r_out = vld1q_f64( reserve_out + i );
+                const float64x2_t denominator = vfmaq_f64( fin, r_in, N );
+                vst1q_f64( out + i, vrndmq_f64( vdivq_f64( vmulq_f64( fin, r_out ), denominator ) ) );
+            }
+#endif
+            for ( ; i < n; ++i ) out[i] = std::floor( in_with_fee * reserve_out[i] / ( reserve_in[i] * 10000 + in_with_fee ) );
+        }
+
+    private:
+        uint8_t                                 _fee;
+        std::unordered_map<uint64_t, size_t>    _slots;         // pair id => column index
+        std::vector<uint64_t>                   _ids;
+        std::vector<int64_t>                    _reserve0;
+        std::vector<int64_t>                    _reserve1;
+        std::vector<double>                     _reserve0d;     // screening copies (0 when not liquid)
+        std::vector<double>                     _reserve1d;
+        std::vector<uint8_t>                    _precision0;
+        std::vector<uint8_t>                    _precision1;
+    };
+} }
@@ -0,0 +1,266 @@
+#pragma once
+
+/**
+ * Parallel 2- & 3-cycle arbitrage scanner over the Hamburger pair graph
+ *
+ * Tokens (`symbol` + `contract` of `token0`/`token1`) are graph nodes and pairs are edges. `build` enumerates
+ * every cycle once (starting at its smallest token); `scan` evaluates them on a pool of threads pulling
+ * fixed-size chunks of cycles from a shared atomic cursor (threads that finish early keep taking chunks, so a
+ * hub token owning most cycles still spreads over every thread) and returns opportunities ranked by profit. 2-cycles use the closed-form `get_arbitrage`
+ * solver; 3-cycles collapse the last two hops into an equivalent constant-product pair to get the solver's
+ * input, then re-quote the exact path with the integer `get_amount_out`.
+ *
+ * Results are cached per cycle with an index from pair to the cycles using it: `update` applies changed
+ * pairs (ex: SHiP `pairs` deltas, see `ship::changed_pair_ids`) and re-evaluates only the affected cycles,
+ * so per-block work scales with trading activity instead of the number of pairs. Native only.
+ */
+
+#include "../math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace hamburger { namespace offchain {
+
+    /**
+     * Profitable cycle (amounts in the raw units of the start token)
+     */
+    struct opportunity {
+        std::array<uint64_t, 3>     pair_ids{};
+        uint8_t                     hops = 0;
+        uint64_t                    symbol = 0;             // start token (raw symbol)
+        uint64_t                    contract = 0;           // start token contract (name value)
+        uint64_t                    amount_in = 0;
+        uint64_t                    profit = 0;
+    };
+
+    class scanner {
+    public:
+        explicit scanner( const unsigned threads = std::max( 1u, std::thread::hardware_concurrency() ) ) : _threads( threads ) {}
+
+        /**
+         * Rebuild the pair graph & cycle list (call again when pairs are created)
+         */
+        void build( const std::vector<pair_state>& pairs, const uint8_t fee )
+        {
+            _fee = fee;
+            _pairs = pairs;
+            _tokens.clear();
+            _cycles.clear();
+            _slots.clear();
+            _pair_cycles.assign( _pairs.size(), {} );
+            _results.clear();
+            _live.clear();
+
+            std::map<std::pair<uint64_t, uint64_t>, uint32_t> ids;
+            std::vector<std::vector<edge>> adjacent;
+            const auto token_id = [&]( const uint64_t symbol, const uint64_t contract ) {
+                const auto [ itr, inserted ] = ids.try_emplace( { symbol, contract }, static_cast<uint32_t>( _tokens.size() ) );
+                if ( inserted ) {
+                    _tokens.push_back( { symbol, contract } );
+                    adjacent.emplace_back();
+                }
+                return itr->second;
+            };
+            for ( uint32_t slot = 0; slot < _pairs.size(); ++slot ) {
+                _slots[_pairs[slot].id] = slot;
+                const uint32_t t0 = token_id( _pairs[slot].symbol0, _pairs[slot].contract0 );
+                const uint32_t t1 = token_id( _pairs[slot].symbol1, _pairs[slot].contract1 );
+                if ( t0 == t1 ) continue;
+                adjacent[t0].push_back( { t1, { slot, false } } );
+                adjacent[t1].push_back( { t0, { slot, true } } );
+            }
+
+            // every cycle starts at its smallest token, both directions are kept
+            for ( uint32_t s = 0; s < _tokens.size(); ++s ) {
+                for ( const edge& e1 : adjacent[s] ) {
+                    if ( e1.to < s ) continue;
+                    for ( const edge& e2 : adjacent[e1.to] ) {
+                        if ( e2.step.slot == e1.step.slot ) continue;
+                        if ( e2.to == s ) _cycles.push_back( { { e1.step, e2.step }, 2, s } );
+                        if ( e2.to <= s ) continue;
+                        for ( const edge& e3 : adjacent[e2.to] ) {
+                            if ( e3.to == s ) _cycles.push_back( { { e1.step, e2.step, e3.step }, 3, s } );
+                        }
+                    }
+                }
+            }
+            for ( uint32_t i = 0; i < _cycles.size(); ++i ) {
+                for ( uint8_t h = 0; h < _cycles[i].size; ++h ) _pair_cycles[_cycles[i].hops[h].slot].push_back( i );
+            }
+            _results.resize( _cycles.size() );
+        }
+
+        size_t cycles() const { return _cycles.size(); }
+
+        /**
+         * Evaluate every cycle in parallel, most profitable first (`max_results` 0 => all)
+         */
+        std::vector<opportunity> scan( const size_t max_results = 0 )
+        {
+            parallel( _cycles.size(), [&]( const size_t i ) { _results[i] = evaluate( _cycles[i] ); } );
+            _live.clear();
+            for ( uint32_t i = 0; i < _results.size(); ++i ) {
+                if ( _results[i].profit ) _live.insert( i );
+            }
+            return best( max_results );
+        }
+
+        /**
+         * Apply changed pairs & re-evaluate only the cycles using them, returns the number of cycles evaluated
+         *
+         * Pairs with unchanged reserves are skipped; returns -1 without applying anything if a pair is unknown
+         * (new pair => `build` again).
+         */
+        int64_t update( const std::vector<pair_state>& pairs )
+        {
+            for ( const pair_state& pair : pairs ) {
+                if ( _slots.find( pair.id ) == _slots.end() ) return -1;
+            }
+
+            std::vector<uint32_t> affected;
+            for ( const pair_state& pair : pairs ) {
+                const auto itr = _slots.find( pair.id );
+                pair_state& current = _pairs[itr->second];
+                if ( current.reserve0 == pair.reserve0 && current.reserve1 == pair.reserve1 ) continue;
+                current = pair;
+                const auto& cycles = _pair_cycles[itr->second];
+                affected.insert( affected.end(), cycles.begin(), cycles.end() );
+            }
+            std::sort( affected.begin(), affected.end() );
+            affected.erase( std::unique( affected.begin(), affected.end() ), affected.end() );
+
+            parallel( affected.size(), [&]( const size_t i ) { _results[affected[i]] = evaluate( _cycles[affected[i]] ); } );
+            for ( const uint32_t i : affected ) {
+                if ( _results[i].profit ) _live.insert( i );
+                else _live.erase( i );
+            }
+            return affected.size();
+        }
+
+        /**
+         * Cached opportunities of the last `scan` / `update`, most profitable first (`max_results` 0 => all)
+         */
+        std::vector<opportunity> best( const size_t max_results = 0 ) const
+        {
+            std::vector<opportunity> res;
+            res.reserve( _live.size() );
+            for ( const uint32_t i : _live ) res.push_back( _results[i] );
+            return rank( std::move( res ), max_results );
+        }
+
+    private:
+        struct hop {
+            uint32_t    slot = 0;
+            bool        reverse = false;                    // input side is reserve1
+        };
+
+        struct edge {
+            uint32_t    to = 0;
+            hop         step;
+        };
+
+        struct cycle {
+            std::array<hop, 3>  hops{};
+            uint8_t             size = 0;
+            uint32_t            start = 0;              // start token
+        };
+
+        static constexpr size_t chunk_size = 16;                // cycles per cursor increment
+        static constexpr size_t cycles_per_thread = 32;         // below this, spawning costs more than evaluating
+
+        // run `job( 0..n )` (one call per cycle) on up to `_threads` threads pulling chunks from a shared atomic cursor
+        template <typename F>
+        void parallel( const size_t n, F&& job ) const
+        {
+            std::atomic<size_t> cursor{ 0 };
+            const auto work = [&]() {
+                for ( size_t begin; ( begin = cursor.fetch_add( chunk_size, std::memory_order_relaxed ) ) < n; ) {
+                    for ( size_t i = begin; i < std::min( n, begin + chunk_size ); ++i ) job( i );
+                }
+            };
+            const size_t threads = std::min<size_t>( _threads, ( n + cycles_per_thread - 1 ) / cycles_per_thread );
+            std::vector<std::thread> workers;
+            for ( size_t t = 1; t < threads; ++t ) workers.emplace_back( work );
+            work();
+            for ( std::thread& worker : workers ) worker.join();
+        }
+
+        static std::vector<opportunity> rank( std::vector<opportunity> res, const size_t max_results )
+        {
+            const auto by_profit = []( const opportunity& a, const opportunity& b ) { return a.profit > b.profit; };
+            if ( max_results && res.size() > max_results ) {
+                std::partial_sort( res.begin(), res.begin() + max_results, res.end(), by_profit );
+                res.resize( max_results );
+            }
+            else std::sort( res.begin(), res.end(), by_profit );
+            return res;
+        }
+
+        std::pair<int64_t, int64_t> reserves( const hop& h ) const
+        {
+            const pair_state& pair = _pairs[h.slot];
+            return h.reverse ? std::pair{ pair.reserve1, pair.reserve0 } : std::pair{ pair.reserve0, pair.reserve1 };
+        }
+
+        // exact output of the path (0 if any hop lacks liquidity)
+        uint64_t quote( const cycle& c, uint64_t amount ) const
+        {
+            for ( uint8_t i = 0; i < c.size && amount; ++i ) {
+                const auto [ reserve_in, reserve_out ] = reserves( c.hops[i] );
+                amount = get_amount_out( amount, reserve_in, reserve_out, _fee );
+            }
+            return amount;
+        }
+
+        opportunity evaluate( const cycle& c ) const
+        {
+            opportunity res;
+            for ( uint8_t i = 0; i < c.size; ++i ) {
+                if ( reserves( c.hops[i] ).first <= 0 || reserves( c.hops[i] ).second <= 0 ) return res;
+            }
+
+            const auto [ r1_in, r1_out ] = reserves( c.hops[0] );
+            const auto [ r2_in, r2_out ] = reserves( c.hops[1] );
+            uint64_t amount_in = 0;
+            if ( c.size == 2 ) amount_in = get_arbitrage( r1_in, r1_out, _fee, r2_in, r2_out, _fee ).first;
+            else {
+                // hops 2 & 3 as one pair: in = r2_in r3_in / (r3_in + g r2_out), out = g r2_out r3_out / (r3_in + g r2_out)
+                const auto [ r3_in, r3_out ] = reserves( c.hops[2] );
+                const double g = ( 10000 - _fee ) / 10000.0;
+                const double d = r3_in + g * r2_out;
+                const double composite_in = static_cast<double>( r2_in ) * r3_in / d;
+                const double composite_out = g * r2_out * r3_out / d;
+                if ( composite_in >= 1 && composite_out >= 1 ) amount_in = get_arbitrage( r1_in, r1_out, _fee, static_cast<uint64_t>( composite_in ), static_cast<uint64_t>( composite_out ), _fee ).first;
+            }
+            if ( amount_in == 0 ) return res;
+
+            const uint64_t out = quote( c, amount_in );
+            if ( out <= amount_in ) return res;
+
+            for ( uint8_t i = 0; i < c.size; ++i ) res.pair_ids[i] = _pairs[c.hops[i].slot].id;
+            res.hops = c.size;
+            res.symbol = _tokens[c.start].first;
+            res.contract = _tokens[c.start].second;
+            res.amount_in = amount_in;
+            res.profit = out - amount_in;
+            return res;
+        }
+
+        unsigned                                        _threads;
+        uint8_t                                         _fee = 0;
+        std::vector<pair_state>                         _pairs;         // by slot
+        std::vector<std::pair<uint64_t, uint64_t>>      _tokens;        // symbol, contract
+        std::vector<cycle>                              _cycles;
+        std::unordered_map<uint64_t, uint32_t>          _slots;         // pair id => slot
+        std::vector<std::vector<uint32_t>>              _pair_cycles;   // slot => cycles using the pair
+        std::vector<opportunity>                        _results;       // by cycle (profit 0 => none)
+        std::unordered_set<uint32_t>                    _live;          // profitable cycles
+    };
+} }
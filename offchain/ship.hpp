@@ -0,0 +1,313 @@
+#pragma once
+
+/**
+ * State-history (SHiP) protocol decoding for Hamburger tables
+ *
+ * Serializes `get_blocks_request_v0` / `get_blocks_ack_request_v0` and decodes `get_blocks_result_v0`
+ * messages into `contract_row` deltas, then decodes `pairs`, `pools`, `config` & `deposits` rows into the
+ * plain structs of `math.hpp` using the packed layouts of `hamburger.hpp`. Native only, no dependencies.
+ */
+
+#include "../math.hpp"
+
+#include <algorithm>
+#include <array>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace hamburger { namespace ship {
+
+    /**
+     * Name value of a string (eosio `name` encoding)
+     */
+    static constexpr uint64_t to_name( const std::string_view str )
+    {
+        constexpr auto char_to_value = []( const char c ) -> uint64_t {
+            if ( c >= 'a' && c <= 'z' ) return ( c - 'a' ) + 6;
+            if ( c >= '1' && c <= '5' ) return ( c - '1' ) + 1;
+            return 0;
+        };
+        uint64_t value = 0;
+        const size_t n = std::min<size_t>( str.size(), 12 );
+        for ( size_t i = 0; i < n; ++i ) value = value << 5 | char_to_value( str[i] );
+        value <<= 4 + 5 * ( 12 - n );
+        if ( str.size() > 12 ) value |= char_to_value( str[12] ) & 0x0f;
+        return value;
+    }
+
+    static constexpr uint64_t code = to_name( "hamburgerswp" );
+    static constexpr uint64_t mine_code = to_name( "hbgtrademine" );
+
+    static constexpr uint64_t pairs_table = to_name( "pairs" );
+    static constexpr uint64_t config_table = to_name( "config" );
+    static constexpr uint64_t deposits_table = to_name( "deposits" );
+    static constexpr uint64_t pools_table = to_name( "pools" );
+
+    /**
+     * Bounds checked little-endian reader over a message buffer
+     */
+    struct reader {
+        const char*         pos;
+        const char*         end;
+
+        template <typename T>
+        T read()
+        {
+            if ( end - pos < static_cast<std::ptrdiff_t>( sizeof( T ) ) ) throw std::runtime_error( "ship: read past end" );
+            T value;
+            std::memcpy( &value, pos, sizeof( T ) );
+            pos += sizeof( T );
+            return value;
+        }
+
+        uint32_t read_varuint32()
+        {
+            uint32_t value = 0;
+            for ( int shift = 0; shift < 35; shift += 7 ) {
+                const uint8_t b = read<uint8_t>();
+                value |= static_cast<uint32_t>( b & 0x7f ) << shift;
+                if ( !( b & 0x80 ) ) return value;
+            }
+            throw std::runtime_error( "ship: invalid varuint32" );
+        }
+
+        // bytes / string view into the buffer (no copy)
+        std::string_view read_bytes()
+        {
+            const uint32_t size = read_varuint32();
+            if ( static_cast<uint32_t>( end - pos ) < size ) throw std::runtime_error( "ship: read past end" );
+            const std::string_view res{ pos, size };
+            pos += size;
+            return res;
+        }
+
+        void skip( const size_t size )
+        {
+            if ( static_cast<size_t>( end - pos ) < size ) throw std::runtime_error( "ship: read past end" );
+            pos += size;
+        }
+    };
+
+    /**
+     * Little-endian writer for requests
+     */
+    struct writer {
+        std::vector<char>   data;
+
+        template <typename T>
+        void write( const T value )
+        {
+            const char* p = reinterpret_cast<const char*>( &value );
+            data.insert( data.end(), p, p + sizeof( T ) );
+        }
+
+        void write_varuint32( uint32_t value )
+        {
+            do {
+                uint8_t b = value & 0x7f;
+                value >>= 7;
+                write<uint8_t>( b | ( value ? 0x80 : 0 ) );
+            } while ( value );
+        }
+    };
+
+    struct block_position {
+        uint32_t                    block_num = 0;
+        std::array<uint8_t, 32>     block_id{};
+    };
+
+    /**
+     * `contract_row_v0` delta (`value` points into the message buffer)
+     */
+    struct contract_row {
+        bool                present = false;
+        uint64_t            code = 0;
+        uint64_t            scope = 0;
+        uint64_t            table = 0;
+        uint64_t            primary_key = 0;
+        uint64_t            payer = 0;
+        std::string_view    value;
+    };
+
+    /**
+     * Decoded `get_blocks_result_v0` (only `contract_row` deltas of the requested codes)
+     */
+    struct blocks_result {
+        block_position                  head;
+        block_position                  last_irreversible;
+        std::optional<block_position>   this_block;
+        std::optional<block_position>   prev_block;
+        std::vector<contract_row>       rows;
+    };
+
+    /**
+     * Serialize `get_blocks_request_v0` (deltas only)
+     */
+    static std::vector<char> get_blocks_request( const uint32_t start_block_num, const uint32_t max_messages_in_flight, const bool irreversible_only = false, const uint32_t end_block_num = 0xffffffff )
+    {
+        writer w;
+        w.write_varuint32( 1 );                     // request variant: get_blocks_request_v0
+        w.write<uint32_t>( start_block_num );
+        w.write<uint32_t>( end_block_num );
+        w.write<uint32_t>( max_messages_in_flight );
+        w.write_varuint32( 0 );                     // have_positions
+        w.write<uint8_t>( irreversible_only );
+        w.write<uint8_t>( false );                  // fetch_block
+        w.write<uint8_t>( false );                  // fetch_traces
+        w.write<uint8_t>( true );                   // fetch_deltas
+        return w.data;
+    }
+
+    /**
+     * Serialize `get_blocks_ack_request_v0`
+     */
+    static std::vector<char> get_blocks_ack_request( const uint32_t num_messages )
+    {
+        writer w;
+        w.write_varuint32( 2 );                     // request variant: get_blocks_ack_request_v0
+        w.write<uint32_t>( num_messages );
+        return w.data;
+    }
+
+    static block_position read_block_position( reader& r )
+    {
+        block_position res;
+        res.block_num = r.read<uint32_t>();
+        res.block_id = r.read<std::array<uint8_t, 32>>();
+        return res;
+    }
+
+    static std::optional<block_position> read_optional_block_position( reader& r )
+    {
+        if ( !r.read<uint8_t>() ) return std::nullopt;
+        return read_block_position( r );
+    }
+
+    /**
+     * Decode a `get_blocks_result_v0` message, keeping `contract_row` deltas of `code` & `mine_code`
+     */
+    static blocks_result parse_blocks_result( const char* data, const size_t size )
+    {
+        reader r{ data, data + size };
+        if ( r.read_varuint32() != 1 ) throw std::runtime_error( "ship: expected get_blocks_result_v0" );
+
+        blocks_result res;
+        res.head = read_block_position( r );
+        res.last_irreversible = read_block_position( r );
+        res.this_block = read_optional_block_position( r );
+        res.prev_block = read_optional_block_position( r );
+        if ( r.read<uint8_t>() ) r.read_bytes();    // block
+        if ( r.read<uint8_t>() ) r.read_bytes();    // traces
+        if ( !r.read<uint8_t>() ) return res;       // deltas
+
+        const std::string_view deltas = r.read_bytes();
+        reader d{ deltas.data(), deltas.data() + deltas.size() };
+        for ( uint32_t n = d.read_varuint32(); n > 0; --n ) {
+            if ( d.read_varuint32() != 0 ) throw std::runtime_error( "ship: expected table_delta_v0" );
+            const std::string_view name = d.read_bytes();
+            const uint32_t count = d.read_varuint32();
+            for ( uint32_t i = 0; i < count; ++i ) {
+                const bool present = d.read<uint8_t>();
+                const std::string_view row = d.read_bytes();
+                if ( name != "contract_row" ) continue;
+
+                reader c{ row.data(), row.data() + row.size() };
+                if ( c.read_varuint32() != 0 ) throw std::runtime_error( "ship: expected contract_row_v0" );
+                contract_row delta;
+                delta.present = present;
+                delta.code = c.read<uint64_t>();
+                if ( delta.code != code && delta.code != mine_code ) continue;
+                delta.scope = c.read<uint64_t>();
+                delta.table = c.read<uint64_t>();
+                delta.primary_key = c.read<uint64_t>();
+                delta.payer = c.read<uint64_t>();
+                delta.value = c.read_bytes();
+                res.rows.push_back( delta );
+            }
+        }
+        return res;
+    }
+
+    /**
+     * Primary keys of the `pairs` rows changed (or removed) by a block
+     */
+    static std::vector<uint64_t> changed_pair_ids( const blocks_result& result )
+    {
+        std::vector<uint64_t> res;
+        for ( const contract_row& row : result.rows ) {
+            if ( row.code == code && row.table == pairs_table ) res.push_back( row.primary_key );
+        }
+        return res;
+    }
+
+    /**
+     * Decode packed `pairs_row`
+     */
+    static pair_state decode_pair( const std::string_view value )
+    {
+        reader r{ value.data(), value.data() + value.size() };
+        pair_state res;
+        res.id = r.read<uint64_t>();
+        r.skip( 8 );                                // code
+        r.skip( 8 );                                // token0.sym
+        res.contract0 = r.read<uint64_t>();
+        r.skip( 8 );                                // token1.sym
+        res.contract1 = r.read<uint64_t>();
+        res.reserve0 = r.read<int64_t>();
+        res.symbol0 = r.read<uint64_t>();
+        res.reserve1 = r.read<int64_t>();
+        res.symbol1 = r.read<uint64_t>();
+        res.total_liquidity = r.read<uint64_t>();
+        res.last_update_time = r.read<uint32_t>();
+        return res;
+    }
+
+    /**
+     * Decode packed `global_row`
+     */
+    static config_state decode_config( const std::string_view value )
+    {
+        reader r{ value.data(), value.data() + value.size() };
+        config_state res;
+        res.contract_status = r.read<uint8_t>();
+        res.mine_status = r.read<uint8_t>();
+        res.trade_fee = r.read<uint8_t>();
+        res.protocol_fee = r.read<uint8_t>();
+        return res;
+    }
+
+    /**
+     * Decode packed `deposits_row`
+     */
+    static deposit_state decode_deposit( const std::string_view value )
+    {
+        reader r{ value.data(), value.data() + value.size() };
+        deposit_state res;
+        res.owner = r.read<uint64_t>();
+        res.quantity0 = r.read<int64_t>();
+        res.symbol0 = r.read<uint64_t>();
+        res.quantity1 = r.read<int64_t>();
+        res.symbol1 = r.read<uint64_t>();
+        return res;
+    }
+
+    /**
+     * Decode packed `pools_row`
+     */
+    static pool_state decode_pool( const std::string_view value )
+    {
+        reader r{ value.data(), value.data() + value.size() };
+        pool_state res;
+        res.pair_id = r.read<uint64_t>();
+        res.weight = r.read<double>();
+        res.balance = r.read<int64_t>();
+        r.skip( 8 );                                // balance.symbol
+        r.skip( 16 );                               // issued
+        res.last_issue_time = r.read<uint32_t>();
+        res.start_time = r.read<uint32_t>();
+        res.end_time = r.read<uint32_t>();
+        return res;
+    }
+} }
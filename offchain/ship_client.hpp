@@ -0,0 +1,78 @@
+#pragma once
+
+/**
+ * SHiP websocket client streaming Hamburger table deltas into a `reserve_book`
+ *
+ * Requires Boost.Beast (header-only), link with `-pthread`.
+ */
+
+#include "book.hpp"
+
+#include <atomic>
+#include <string>
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+namespace hamburger { namespace offchain {
+
+    class ship_client {
+    public:
+        ship_client( reserve_book& book, std::string host, std::string port )
+            : _book( book ), _host( std::move( host ) ), _port( std::move( port ) ) {}
+
+        /**
+         * Stream blocks into the book until `stop()` (blocking, throws on connection errors)
+         *
+         * Resumes after the book head when `start_block_num` is 0, `irreversible_only` streams irreversible
+         * blocks only (no forks, ex: for books persisted with `book_file`).
+         */
+        void run( uint32_t start_block_num = 0, const uint32_t max_messages_in_flight = 1000, const bool irreversible_only = false )
+        {
+            namespace websocket = boost::beast::websocket;
+            using tcp = boost::asio::ip::tcp;
+
+            if ( start_block_num == 0 ) start_block_num = _book.block_num() + 1;
+
+            boost::asio::io_context ioc;
+            tcp::resolver resolver( ioc );
+            websocket::stream<tcp::socket> ws( ioc );
+            boost::asio::connect( ws.next_layer(), resolver.resolve( _host, _port ) );
+            ws.handshake( _host, "/" );
+            ws.read_message_max( 0 );
+
+            // first message is the state history ABI (text)
+            boost::beast::flat_buffer buffer;
+            ws.read( buffer );
+            buffer.consume( buffer.size() );
+
+            ws.binary( true );
+            ws.write( boost::asio::buffer( ship::get_blocks_request( start_block_num, max_messages_in_flight, irreversible_only ) ) );
+
+            const uint32_t ack_every = std::max<uint32_t>( 1, max_messages_in_flight / 2 );
+            uint32_t unacked = 0;
+            while ( !_stop ) {
+                ws.read( buffer );
+                const auto data = buffer.data();
+                _book.apply( ship::parse_blocks_result( static_cast<const char*>( data.data() ), data.size() ) );
+                buffer.consume( buffer.size() );
+
+                if ( ++unacked >= ack_every ) {
+                    ws.write( boost::asio::buffer( ship::get_blocks_ack_request( unacked ) ) );
+                    unacked = 0;
+                }
+            }
+            ws.close( websocket::close_code::normal );
+        }
+
+        void stop() { _stop = true; }
+
+    private:
+        reserve_book&       _book;
+        std::string         _host;
+        std::string         _port;
+        std::atomic<bool>   _stop{ false };
+    };
+} }
@@ -0,0 +1,102 @@
+#pragma once
+
+/**
+ * Optional per-helper instrumentation
+ *
+ * Build with `-DHAMBURGER_PROFILE` to count calls, DB reads & cache hits of the helpers within an action
+ * (contract statics live for a single action, so counters start at zero for each one). Without the macro
+ * every `HAMBURGER_PROFILE_*` hook expands to nothing.
+ */
+
+#ifdef HAMBURGER_PROFILE
+
+#include <eosio/print.hpp>
+
+#include <array>
+#include <string>
+
+namespace hamburger { namespace profile {
+
+    enum class helper : uint8_t {
+        get_config,
+        get_fee,
+        is_trading_enabled,
+        is_mining_enabled,
+        read_reserves,
+        get_reserves,
+        get_reserves_many,
+        get_amount_out,
+        get_amount_in,
+        get_rewards,
+        snapshot_get_config,
+        snapshot_get_pair,
+        count
+    };
+
+    static constexpr const char* names[] = {
+        "get_config", "get_fee", "is_trading_enabled", "is_mining_enabled", "read_reserves", "get_reserves",
+        "get_reserves_many", "get_amount_out", "get_amount_in", "get_rewards", "snapshot.get_config", "snapshot.get_pair"
+    };
+    static_assert( sizeof( names ) / sizeof( names[0] ) == static_cast<size_t>( helper::count ) );
+
+    struct counters {
+        uint32_t    calls = 0;
+        uint32_t    db_reads = 0;
+        uint32_t    cache_hits = 0;
+    };
+
+    static std::array<counters, static_cast<size_t>( helper::count )>& stats()
+    {
+        static std::array<counters, static_cast<size_t>( helper::count )> res;
+        return res;
+    }
+
+    /**
+     * Compact summary of helpers used so far: `name:calls/db_reads/cache_hits` separated by spaces
+     *
+     * ### example
+     *
+     * ```c++
+     * hamburger::get_fee();
+     * hamburger::get_fee();
+     * hamburger::profile::summary();
+     * // => "get_config:2/1/1 get_fee:2/0/0"
+     * ```
+     */
+    static std::string summary()
+    {
+        std::string res;
+        for ( size_t i = 0; i < stats().size(); ++i ) {
+            const counters& c = stats()[i];
+            if ( !c.calls && !c.db_reads && !c.cache_hits ) continue;
+            if ( !res.empty() ) res += " ";
+            res += std::string( names[i] ) + ":" + std::to_string( c.calls ) + "/" + std::to_string( c.db_reads ) + "/" + std::to_string( c.cache_hits );
+        }
+        return res;
+    }
+
+    /**
+     * Print the summary (console of the action)
+     */
+    static void print()
+    {
+        eosio::print( summary() );
+    }
+
+    static void reset()
+    {
+        stats() = {};
+    }
+} }
+
+#define HAMBURGER_PROFILE_CALL( h ) ( ++::hamburger::profile::stats()[static_cast<size_t>( ::hamburger::profile::helper::h )].calls )
+#define HAMBURGER_PROFILE_DB_READ( h ) ( ++::hamburger::profile::stats()[static_cast<size_t>( ::hamburger::profile::helper::h )].db_reads )
+#define HAMBURGER_PROFILE_CACHE_HIT( h ) ( ++::hamburger::profile::stats()[static_cast<size_t>( ::hamburger::profile::helper::h )].cache_hits )
+
+#else
+
+#define HAMBURGER_PROFILE_CALL( h ) ( (void) 0 )
+#define HAMBURGER_PROFILE_DB_READ( h ) ( (void) 0 )
+#define HAMBURGER_PROFILE_CACHE_HIT( h ) ( (void) 0 )
+
+#endif
@@ -0,0 +1,115 @@
+// build: eosio-cpp quoter/quoter.cpp -I ../ -o quoter.wasm (CDT 3+ for read-only actions)
+#include <eosio/eosio.hpp>
+
+#include <sx.hamburger/hamburger.hpp>
+
+using namespace eosio;
+
+/**
+ * Read-only Hamburger quoter
+ *
+ * Every action returns its result as a binary-packed `return_value`, call them with
+ * `send_read_only_transaction` (`cleos push action --read-only`) to get reserves, fee, amount out
+ * & rewards in a single RPC round trip.
+ */
+class [[eosio::contract]] quoter : public contract {
+
+public:
+    using contract::contract;
+
+    struct pair_result {
+        uint64_t            id;
+        extended_symbol     token0;
+        extended_symbol     token1;
+        asset               reserve0;
+        asset               reserve1;
+        uint64_t            total_liquidity;
+        uint32_t            last_update_time;
+    };
+
+    struct quote_result {
+        uint64_t            pair_id;
+        asset               reserve_in;
+        asset               reserve_out;
+        uint8_t             fee;
+        asset               out;
+        asset               rewards;
+    };
+
+    struct status_result {
+        uint8_t             fee;
+        bool                trading;
+        bool                mining;
+    };
+
+    /**
+     * Fee & status of Hamburger
+     */
+    [[eosio::action, eosio::read_only]]
+    status_result getstatus()
+    {
+        return { hamburger::get_fee(), hamburger::is_trading_enabled(), hamburger::is_mining_enabled() };
+    }
+
+    /**
+     * Pair rows (table order reserves)
+     */
+    [[eosio::action, eosio::read_only]]
+    std::vector<pair_result> getpairs( const std::vector<uint64_t> pair_ids )
+    {
+        hamburger::snapshot snapshot;
+        std::vector<pair_result> res;
+        res.reserve( pair_ids.size() );
+        for ( const uint64_t pair_id : pair_ids ) {
+            const auto& pair = snapshot.get_pair( pair_id );
+            res.push_back( { pair.id, pair.token0, pair.token1, pair.reserve0, pair.reserve1, pair.total_liquidity, pair.last_update_time } );
+        }
+        return res;
+    }
+
+    /**
+     * Reserves, fee, amount out & mining rewards of each (pair id, input) quote
+     */
+    [[eosio::action, eosio::read_only]]
+    std::vector<quote_result> quote( const std::vector<std::pair<uint64_t, asset>> quotes )
+    {
+        hamburger::snapshot snapshot;
+        const uint8_t fee = snapshot.get_fee();
+
+        std::vector<quote_result> res;
+        res.reserve( quotes.size() );
+        for ( const auto& [ pair_id, in ] : quotes ) {
+            const auto [ reserve_in, reserve_out ] = snapshot.get_reserves( pair_id, in.symbol );
+            const asset out = snapshot.get_amount_out( pair_id, in );
+            res.push_back( { pair_id, reserve_in, reserve_out, fee, out, hamburger::get_rewards( pair_id, in, out ) } );
+        }
+        return res;
+    }
+
+    /**
+     * Output of each hop of a path
+     */
+    [[eosio::action, eosio::read_only]]
+    std::vector<asset> quotepath( const asset in, const std::vector<uint64_t> pair_ids )
+    {
+        return hamburger::quote_path( in, pair_ids );
+    }
+
+    /**
+     * Candidate routes ranked by output plus HBG rewards valued at `hbg_price`
+     */
+    [[eosio::action, eosio::read_only]]
+    std::vector<hamburger::route_quote> rankroutes( const asset in, const std::vector<std::vector<uint64_t>> routes, const asset hbg_price )
+    {
+        return hamburger::rank_routes( in, routes, hbg_price );
+    }
+
+    /**
+     * Emission rate & rewards of active mining pools for an EOS input
+     */
+    [[eosio::action, eosio::read_only]]
+    std::vector<hamburger::pool_rewards> getpools( const asset in )
+    {
+        return hamburger::get_pools_rewards( in );
+    }
+};
@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# usage: ./scripts/bench.sh [pairs=20] [iterations=50]
+N=${1:-20}
+K=${2:-50}
+RUNS=5
+
+# unlock wallet
+cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
+
+# create accounts (benchmark contract stands in for Hamburger tables)
+cleos create account eosio hamburgerswp EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+cleos create account eosio hbgtrademine EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+
+# build
+eosio-cpp __tests__/bench.cpp -I ../ -o bench.wasm
+
+# deploy
+cleos set contract hamburgerswp . bench.wasm bench.abi
+cleos set contract hbgtrademine . bench.wasm bench.abi
+
+# seed
+cleos push action hamburgerswp seed "[$N]" -p hamburgerswp
+cleos push action hbgtrademine seedpools "[$N]" -p hbgtrademine
+
+# billed cpu (µs) of a single action, best of $RUNS
+cpu() {
+    for i in $(seq $RUNS); do
+        cleos -j push action -f hamburgerswp "$@" -p hamburgerswp | jq '.processed.receipt.cpu_usage_us'
+    done | sort -n | head -1
+}
+
+printf "%-14s %10s %12s\n" "helper" "cpu_us" "per_call_us"
+base=$(cpu run "[\"noop\", $N, $K]")
+printf "%-14s %10s %12s\n" "noop" "$base" "-"
+
+for helper in getfee getreserves getreservest readreserves getmany amountout quotepath getrewards; do
+    us=$(cpu run "[\"$helper\", $N, $K]")
+    printf "%-14s %10s %12s\n" "$helper" "$us" "$(echo "scale=2; ($us - $base) / $K" | bc)"
+done
+
+us=$(cpu runsnapshot "[$N, $K]")
+printf "%-14s %10s %12s\n" "snapshot" "$us" "$(echo "scale=2; ($us - $base) / $K" | bc)"
@@ -0,0 +1,22 @@
+#!/bin/bash
+
+# usage: ./scripts/record.sh <api> [recording=recording.txt] [swaps]
+# records Hamburger config, pairs & pools from an API node, then appends a swap log (`<pair_id> <amount> <symbol>` per line,
+# ex: exported from a history service) for ./scripts/replay.sh
+API=$1
+RECORDING=${2:-recording.txt}
+SWAPS=$3
+
+table() {
+    cleos -u $API get table $1 $1 $2 --limit 10000
+}
+
+{
+    echo "# recorded from $API at $(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    table hamburgerswp config | jq -r '.rows[] | "config \(.contract_status) \(.mine_status) \(.trade_fee) \(.protocol_fee)"'
+    table hamburgerswp pairs | jq -r '.rows[] | "pair \(.id) \(.token0.contract) \(.reserve0) \(.token1.contract) \(.reserve1) \(.total_liquidity) \(.last_update_time)"'
+    table hbgtrademine pools | jq -r '.rows[] | "pool \(.pair_id) \(.weight) \(.balance | split(" ")[0]) \(.last_issue_time) \(.start_time) \(.end_time)"'
+    [ -n "$SWAPS" ] && sed -e '/^\s*$/d' -e 's/^/swap /' "$SWAPS"
+} > "$RECORDING"
+
+echo "$RECORDING: $(grep -c '^pair ' "$RECORDING") pairs, $(grep -c '^pool ' "$RECORDING") pools, $(grep -c '^swap ' "$RECORDING") swaps"
@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# usage: ./scripts/replay.sh [recording=__tests__/replay.txt]
+# replays recorded rows & swaps on a local node (./scripts/start_nodeos.sh), then checks the off-chain mirror in lockstep
+RECORDING=${1:-__tests__/replay.txt}
+RESULTS=replay_results.txt
+
+# unlock wallet
+cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
+
+# create accounts (benchmark contract stands in for Hamburger tables)
+cleos create account eosio hamburgerswp EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+cleos create account eosio hbgtrademine EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+
+# build
+eosio-cpp __tests__/bench.cpp -I ../ -o bench.wasm
+g++ -std=c++17 -pthread -O2 __tests__/replay.cpp -I ../ -o replay
+
+# deploy
+cleos set contract hamburgerswp . bench.wasm bench.abi
+cleos set contract hbgtrademine . bench.wasm bench.abi
+
+# decimals of an amount, ex: 1.0000 => 4
+precision() {
+    local decimals=${1#*.}
+    [[ $1 == *.* ]] && echo ${#decimals} || echo 0
+}
+
+# load recorded rows
+while read -r type a b c d e f g h i; do
+    case $type in
+        config)
+            cleos push action hamburgerswp setconfig "[{\"contract_status\": $a, \"mine_status\": $b, \"trade_fee\": $c, \"protocol_fee\": $d}]" -p hamburgerswp ;;
+        pair)
+            cleos push action hamburgerswp setpair "[{\"id\": $a, \"code\": \"HBGLP\", \
+\"token0\": {\"sym\": \"$(precision $c),$d\", \"contract\": \"$b\"}, \"token1\": {\"sym\": \"$(precision $f),$g\", \"contract\": \"$e\"}, \
+\"reserve0\": \"$c $d\", \"reserve1\": \"$f $g\", \"total_liquidity\": $h, \"last_update_time\": $i, \"created_time\": $i}]" -p hamburgerswp ;;
+        pool)
+            cleos push action hbgtrademine setpool "[{\"pair_id\": $a, \"weight\": $b, \"balance\": \"$c HBG\", \"issued\": \"0.000000 HBG\", \
+\"last_issue_time\": $d, \"start_time\": $e, \"end_time\": $f}]" -p hbgtrademine ;;
+    esac
+done < <(grep -E '^(config|pair|pool) ' "$RECORDING")
+
+# replay swaps in order => `out rewards now cpu_us` per swap
+: > $RESULTS
+start=$(date +%s.%N)
+while read -r type pair_id amount symbol; do
+    cleos -j push action -f hamburgerswp replayswap "[$pair_id, \"$amount $symbol\"]" -p hamburgerswp \
+        | jq -r '.processed.action_traces[0].console + " " + (.processed.receipt.cpu_usage_us | tostring)' >> $RESULTS
+done < <(grep -E '^swap ' "$RECORDING")
+elapsed=$(echo "$(date +%s.%N) - $start" | bc)
+swaps=$(wc -l < $RESULTS)
+printf "%-12s %.1f swaps/sec (%d swaps, every helper cross-checked on chain)\n" "chain" "$(echo "$swaps / $elapsed" | bc -l)" "$swaps"
+
+# off-chain mirror (exit 1 on divergence)
+./replay "$RECORDING" $RESULTS
+# //=> swaps        12
+# //=> divergences  0
+# //=> cpu_us       p50 ...  p90 ...  p99 ...  max ...
+# //=> mirror       ... quotes/sec
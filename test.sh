@@ -1,5 +1,9 @@
 #!/bin/bash
 
+# native math
+g++ -std=c++17 -pthread __tests__/native.cpp -I ../ -o native && ./native
+# //=> ok
+
 # unlock wallet
 cleos wallet unlock --password $(cat ~/eosio-wallet/.pass)
 
@@ -17,6 +21,135 @@ cleos set contract basic . basic.wasm basic.abi
 cleos -v push action basic getreserves '[1, "4,EOS"]' -p basic
 # //=>
 
+# readreserves
+cleos -v push action basic readreserves '[1]' -p basic
+# //=>
+
+# getmany
+cleos -v push action basic getmany '[[{"first": 1, "second": "4,EOS"}, {"first": 12, "second": "4,EOS"}]]' -p basic
+# //=>
+
+# getsnapshot
+cleos -v push action basic getsnapshot '[1, "4,EOS"]' -p basic
+# //=>
+
+# getamountout
+cleos -v push action basic getamountout '[1, "1.0000 EOS"]' -p basic
+# //=>
+
+# getquotes
+cleos -v push action basic getquotes '[1, "1.0000 EOS"]' -p basic
+# //=>
+
+# getamountin
+cleos -v push action basic getamountin '[1, "1.0000 USDT"]' -p basic
+# //=>
+
+# getimpact
+cleos -v push action basic getimpact '[1, "100.0000 EOS", 50]' -p basic
+# //=>
+
+# getprice
+cleos -v push action basic getprice '[1, "4,EOS", "2.5000 USDT"]' -p basic
+# //=>
+
+# snapshots
+cleos -v push action basic snapshots '[[1, 12]]' -p basic
+# //=> 62
+
+# indexpairs (pairindex of basic, resumable)
+cleos -v push action basic indexpairs '[0]' -p basic
+# //=> next pair id
+
+# getpairid (both orders & snapshot)
+cleos -v push action basic getpairid '[{"sym": "4,EOS", "contract": "eosio.token"}, {"sym": "4,USDT", "contract": "tethertether"}]' -p basic
+# //=> 1 1 1
+cleos -v push action basic getpairid '[{"sym": "4,USDT", "contract": "tethertether"}, {"sym": "4,EOS", "contract": "eosio.token"}]' -p basic
+# //=> 1 1 1
+
+# getpairid (unknown pair, wrong contract)
+cleos -v push action basic getpairid '[{"sym": "4,EOS", "contract": "eosio.token"}, {"sym": "4,FOO", "contract": "eosio.token"}]' -p basic
+# //=> 0 0 0
+cleos -v push action basic getpairid '[{"sym": "4,EOS", "contract": "fake.token"}, {"sym": "4,USDT", "contract": "tethertether"}]' -p basic
+# //=> 0 0 0
+
+# quotepath
+cleos -v push action basic quotepath '["1.0000 EOS", [1, 1]]' -p basic
+# //=>
+
+# getarb
+cleos -v push action basic getarb '[1, 12, "4,EOS"]' -p basic
+# //=>
+
+# getrewards
+cleos -v push action basic getrewards '[1, "10.0000 EOS", "26.5000 USDT"]' -p basic
+# //=>
+
+# getdeposit
+cleos -v push action basic getdeposit '["myaccount"]' -p basic
+# //=>
+
+# getposition
+cleos -v push action basic getposition '["myaccount", 1, 1000000]' -p basic
+# //=>
+
+# addliquidity
+cleos -v push action basic addliquidity '[1, "1.0000 EOS", "3.0000 USDT"]' -p basic
+# //=>
+
+# rmliquidity
+cleos -v push action basic rmliquidity '[1, 10000]' -p basic
+# //=>
+
+# getpools
+cleos -v push action basic getpools '[]' -p basic
+# //=>
+
+# getconfig
+cleos -v push action basic getconfig '[]' -p basic
+# //=> 130
+
+# getstatus
+cleos -v push action basic getstatus '[]' -p basic
+# //=> 11
+
+# twap (60s window, 10s slots)
+for i in $(seq 7); do cleos push action basic twapupdate '[1]' -p basic; sleep 10; done
+cleos -v push action basic twapconsult '[1, "1.0000 EOS"]' -p basic
+# //=>
+
+# rankroutes
+cleos -v push action basic rankroutes '["1.0000 USDT", [[1], [12]], "0.0100 EOS"]' -p basic
+# //=>
+cleos -v push action basic rankroutes '["1.0000 USDT", [[1], [12]], "-0.0100 EOS"]' -p basic
+# //=> Error 3050003: eosio_assert_message assertion failure: HamburgerLibrary: INVALID_PRICE
+
 # getfee
 cleos -v push action basic getfee '[]' -p basic
 # //=> 30
+
+# profiled build (helper counters, same actions)
+cleos create account eosio basicprof EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+eosio-cpp __tests__/basic.cpp -I ../ -DHAMBURGER_PROFILE -o basicprof.wasm
+cleos set contract basicprof . basicprof.wasm basicprof.abi
+
+# getquotes (config read once for three quotes)
+cleos -v push action basicprof getquotes '[1, "1.0000 EOS"]' -p basicprof
+# //=> get_config:3/1/2 get_fee:3/0/0 read_reserves:3/3/0 get_amount_out:2/0/0 get_amount_in:1/0/0
+
+# getrewards (non-EOS pair reads no table)
+cleos -v push action basicprof getrewards '[1, "1.0000 USDT", "1.0000 USDC"]' -p basicprof
+# //=> 0.000000 HBG get_rewards:1/0/0
+
+# getprofile
+cleos -v push action basicprof getprofile '[1, "1.0000 EOS"]' -p basicprof
+# //=> get_config:3/1/2 get_fee:1/0/0 is_mining_enabled:1/0/0 read_reserves:1/1/0 get_amount_out:1/0/0 get_rewards:1/1/0 snapshot.get_config:1/0/0 snapshot.get_pair:2/1/1
+
+# quoter (read-only, results in return_value)
+cleos create account eosio quoter EOS6MRyAjQq8ud7hVNYcfnVPJqcVpscN5So8BhtHuGYqET5GDW5CV
+eosio-cpp quoter/quoter.cpp -I ../ -o quoter.wasm
+cleos set contract quoter . quoter.wasm quoter.abi
+cleos -v push action --read-only quoter getstatus '[]' -p quoter
+# //=> {"fee": 30, "trading": true, "mining": true}
+cleos -v push action --read-only quoter quote '[[{"first": 1, "second": "1.0000 EOS"}]]' -p quoter
+# //=>
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "hamburger.hpp"
+
+namespace hamburger {
+
+    /**
+     * TWAP observations (owned by the consuming contract, scope: pair id)
+     *
+     * Slots `0..granularity-1` form the ring buffer (one per `window / granularity` seconds),
+     * slot `granularity` holds the latest observation.
+     */
+    struct [[eosio::table("twap")]] observations_row {
+        uint64_t        slot;
+        uint32_t        timestamp;
+        uint128_t       price0;             // Q64.64 reserve1 / reserve0 at `timestamp`
+        uint128_t       price1;             // Q64.64 reserve0 / reserve1 at `timestamp`
+        uint128_t       cumulative0;        // wrapping sum of price0 × seconds
+        uint128_t       cumulative1;
+
+        uint64_t primary_key() const { return slot; }
+    };
+    typedef eosio::multi_index< "twap"_n, observations_row > observations;
+
+    /**
+     * ## CLASS `oracle`
+     *
+     * Sliding window time-weighted average price of a pair
+     *
+     * Call `update` from any action touching the pair (writes at most the latest row and the current ring slot),
+     * `consult` prices over the last `window` seconds in O(1): the oldest ring slot, the latest observation and
+     * the pair row, extrapolated to now with `last_update_time`.
+     *
+     * ### params
+     *
+     * - `{name} self` - contract owning the `twap` table
+     * - `{uint64_t} pair_id` - pair id
+     * - `{uint32_t} [window=3600]` - averaging window (seconds)
+     * - `{uint32_t} [granularity=12]` - ring buffer slots (window must be a multiple)
+     *
+     * ### example
+     *
+     * ```c++
+     * hamburger::oracle oracle( get_self(), 12 );
+     * oracle.update( get_self() );
+     *
+     * const asset out = oracle.consult( asset{10000, symbol{"EOS", 4}} );
+     * // => "2.7410 USDT" (1h average)
+     * ```
+     */
+    class oracle {
+    public:
+        oracle( const name self, const uint64_t pair_id, const uint32_t window = 3600, const uint32_t granularity = 12 )
+            : _pair_id( pair_id ), _window( window ), _granularity( granularity ), _observations( self, pair_id )
+        {
+            eosio::check( granularity > 1 && window % granularity == 0, "HamburgerLibrary: INVALID_WINDOW" );
+        }
+
+        /**
+         * Record an observation of the pair (current ring slot is written once per period)
+         */
+        void update( const name payer )
+        {
+            const uint32_t now = eosio::current_time_point().sec_since_epoch();
+            const observations_row latest = observe( now );
+            const uint64_t slot = now / period() % _granularity;
+
+            store( _granularity, latest, payer );
+            const auto itr = _observations.find( slot );
+            if ( itr == _observations.end() || now - itr->timestamp >= period() ) store( slot, latest, payer );
+        }
+
+        /**
+         * Get average prices over the window
+         *
+         * ### returns
+         *
+         * - `{pair<uint128_t, uint128_t>}` - Q64.64 average of reserve1 / reserve0 & reserve0 / reserve1
+         */
+        std::pair<uint128_t, uint128_t> consult()
+        {
+            const uint32_t now = eosio::current_time_point().sec_since_epoch();
+            const observations_row& oldest = _observations.get( ( now / period() + 1 ) % _granularity, "HamburgerLibrary: MISSING_HISTORICAL_OBSERVATION" );
+            eosio::check( now - oldest.timestamp <= _window && now > oldest.timestamp, "HamburgerLibrary: MISSING_HISTORICAL_OBSERVATION" );
+
+            const observations_row current = observe( now );
+            return {
+                get_average_price( oldest.cumulative0, oldest.timestamp, current.cumulative0, now ),
+                get_average_price( oldest.cumulative1, oldest.timestamp, current.cumulative1, now )
+            };
+        }
+
+        /**
+         * Convert an amount of one token of the pair at the average price
+         */
+        asset consult( const asset in )
+        {
+            const pairs_row& pair = get_pair();
+            const auto [ price0, price1 ] = consult();
+            eosio::check( in.symbol == pair.reserve0.symbol || in.symbol == pair.reserve1.symbol, "HamburgerLibrary: INVALID_SYMBOL" );
+
+            if ( in.symbol == pair.reserve0.symbol ) return { static_cast<int64_t>( get_price_amount( in.amount, price0 ) ), pair.reserve1.symbol };
+            return { static_cast<int64_t>( get_price_amount( in.amount, price1 ) ), pair.reserve0.symbol };
+        }
+
+    private:
+        uint32_t period() const { return _window / _granularity; }
+
+        const pairs_row& get_pair()
+        {
+            if ( !_pair ) {
+                hamburger::pairs _pairs( code, code.value );
+                _pair = _pairs.get( _pair_id, "HamburgerLibrary: INVALID_PAIR_ID" );
+            }
+            return *_pair;
+        }
+
+        // latest observation advanced to `now` with the current reserves
+        observations_row observe( const uint32_t now )
+        {
+            const pairs_row& pair = get_pair();
+            const uint128_t price0 = get_price( pair.reserve0.amount, pair.reserve1.amount );
+            const uint128_t price1 = get_price( pair.reserve1.amount, pair.reserve0.amount );
+
+            const auto itr = _observations.find( _granularity );
+            if ( itr == _observations.end() ) return { _granularity, now, price0, price1, 0, 0 };
+            return {
+                _granularity, now, price0, price1,
+                get_cumulative( itr->cumulative0, itr->price0, itr->timestamp, price0, pair.last_update_time, now ),
+                get_cumulative( itr->cumulative1, itr->price1, itr->timestamp, price1, pair.last_update_time, now )
+            };
+        }
+
+        void store( const uint64_t slot, observations_row row, const name payer )
+        {
+            row.slot = slot;
+            const auto itr = _observations.find( slot );
+            if ( itr == _observations.end() ) _observations.emplace( payer, [&]( auto& r ) { r = row; } );
+            else _observations.modify( itr, payer, [&]( auto& r ) { r = row; } );
+        }
+
+        uint64_t                    _pair_id;
+        uint32_t                    _window;
+        uint32_t                    _granularity;
+        hamburger::observations     _observations;
+        std::optional<pairs_row>    _pair;
+    };
+}